@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "monadic_operations.hpp"
+
+/*
+counters of a hedged_or_else monad, shared by all its copies.
+*/
+struct hedge_stats {
+    std::atomic<std::size_t> calls{0};
+    std::atomic<std::size_t> hedges{0};
+    std::atomic<std::size_t> primary_wins{0};
+    std::atomic<std::size_t> fallback_wins{0};
+    std::atomic<std::size_t> cancellations{0};
+};
+
+/*
+handed to fallbacks that accept it. requested() turns true once the race is decided without them,
+long running fallbacks should check it and give up.
+*/
+class hedge_cancellation {
+public:
+    explicit hedge_cancellation(std::shared_ptr<const std::atomic<bool>> requested) : requested_{std::move(requested)} {}
+
+    bool requested() const noexcept {
+        return requested_->load(std::memory_order_relaxed);
+    }
+
+private:
+    std::shared_ptr<const std::atomic<bool>> requested_;
+};
+
+/*
+default executor of hedged_or_else: runs every task on its own detached thread.
+*/
+struct detached_thread_executor {
+    void operator()(std::function<void()> task) const {
+        std::thread(std::move(task)).detach();
+    }
+};
+
+namespace detail {
+
+template <typename T>
+struct hedge_race {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::optional<T> winner;
+    bool fallback_won = false;
+    bool loser_cancelled = false;
+    int finished = 0;
+    std::exception_ptr error;
+    std::shared_ptr<std::atomic<bool>> cancel_requested = std::make_shared<std::atomic<bool>>(false);
+
+    void publish(std::optional<T> result, bool from_fallback) {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            ++finished;
+            if (!winner && result) {
+                winner = std::move(result);
+                fallback_won = from_fallback;
+                loser_cancelled = finished < 2;
+                cancel_requested->store(true, std::memory_order_relaxed);
+            }
+        }
+        done.notify_all();
+    }
+
+    /*
+    a side that threw finishes without a result. the error is only rethrown if the other side does not win either.
+    */
+    void fail(std::exception_ptr exception) {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            ++finished;
+            if (!error) {
+                error = std::move(exception);
+            }
+        }
+        done.notify_all();
+    }
+};
+
+template <typename T, typename F>
+std::optional<T> run_fallback(F& f, const hedge_cancellation& cancellation) {
+    if constexpr (std::is_invocable_v<F&, const hedge_cancellation&>) {
+        return std::optional<T>{f(cancellation)};
+    } else {
+        return std::optional<T>{f()};
+    }
+}
+
+}
+
+template <typename F, typename Executor>
+class hedged_or_else_monad {
+public:
+    hedged_or_else_monad(F f, std::chrono::nanoseconds budget, Executor executor)
+        : f_{std::make_shared<F>(std::move(f))}, budget_{budget}, executor_{std::move(executor)} {}
+
+    template <typename T>
+    std::optional<T> operator()(std::future<std::optional<T>>&& primary) const {
+        ++stats_->calls;
+
+        if (primary.wait_for(budget_) == std::future_status::ready) {
+            if (auto result = primary.get()) {
+                ++stats_->primary_wins;
+                return result;
+            }
+            auto result = detail::run_fallback<T>(*f_, hedge_cancellation{std::make_shared<std::atomic<bool>>(false)});
+            if (result) {
+                ++stats_->fallback_wins;
+            }
+            return result;
+        }
+
+        ++stats_->hedges;
+        auto race = std::make_shared<detail::hedge_race<T>>();
+        auto pending = std::make_shared<std::future<std::optional<T>>>(std::move(primary));
+
+        executor_([race, f = f_]() {
+            try {
+                race->publish(detail::run_fallback<T>(*f, hedge_cancellation{race->cancel_requested}), true);
+            } catch (...) {
+                race->fail(std::current_exception());
+            }
+        });
+        executor_([race, pending]() {
+            try {
+                race->publish(pending->get(), false);
+            } catch (...) {
+                race->fail(std::current_exception());
+            }
+        });
+
+        std::unique_lock<std::mutex> lock{race->mutex};
+        race->done.wait(lock, [&race]() { return race->winner.has_value() || race->finished == 2; });
+
+        if (!race->winner) {
+            if (race->error) {
+                std::rethrow_exception(race->error);
+            }
+            return std::nullopt;
+        }
+        ++(race->fallback_won ? stats_->fallback_wins : stats_->primary_wins);
+        if (race->loser_cancelled) {
+            ++stats_->cancellations;
+        }
+        return std::move(race->winner);
+    }
+
+    template <typename T>
+    std::optional<T> operator()(std::future<std::optional<T>>& primary) const {
+        return (*this)(std::move(primary));
+    }
+
+    const hedge_stats& stats() const noexcept {
+        return *stats_;
+    }
+
+private:
+    std::shared_ptr<F> f_;
+    std::chrono::nanoseconds budget_;
+    Executor executor_;
+    std::shared_ptr<hedge_stats> stats_ = std::make_shared<hedge_stats>();
+};
+
+/*
+returns monad that takes a future of optional<T> (the primary) and returns optional<T>.
+waits up to budget for the primary. if it is ready by then, behaves like or_else: returns it if it has value, the fallback result otherwise.
+if it is not, the fallback is started on executor and the first engaged result of the two wins. nullopt if both come back empty.
+given function returns T or optional<T>, and may take a const hedge_cancellation& to learn when the primary won.
+an exception from the primary or the fallback is rethrown from here, unless the other one wins the race with a value.
+once the hedge fires, the fallback may still be running after the call returns (the primary won), so whatever it captures by
+reference has to outlive every call that may hedge. capture by value otherwise.
+executor is called with a std::function<void()> per task and has to run it eventually, on another thread.
+*/
+template <typename F, typename Rep, typename Period, typename Executor>
+auto hedged_or_else(F&& f, std::chrono::duration<Rep, Period> budget, Executor&& executor) {
+    return hedged_or_else_monad<std::decay_t<F>, std::decay_t<Executor>>{
+        std::forward<F>(f), std::chrono::duration_cast<std::chrono::nanoseconds>(budget), std::forward<Executor>(executor)};
+}
+
+template <typename F, typename Rep, typename Period>
+auto hedged_or_else(F&& f, std::chrono::duration<Rep, Period> budget) {
+    return hedged_or_else(std::forward<F>(f), budget, detached_thread_executor{});
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "monadic_operations.hpp"
+
+namespace detail {
+
+template <typename T>
+constexpr inline bool is_reference_wrapper_v = false;
+
+template <typename T>
+constexpr inline bool is_reference_wrapper_v<std::reference_wrapper<T>> = true;
+
+template <typename Input, typename... Monads>
+struct stage_results {
+    using type = std::tuple<>;
+};
+
+template <typename Input, typename Monad, typename... Monads>
+struct stage_results<Input, Monad, Monads...> {
+    using result_type = std::decay_t<std::invoke_result_t<const Monad&, const Input&>>;
+    using type = decltype(std::tuple_cat(std::declval<std::tuple<std::optional<result_type>>>(),
+                                         std::declval<typename stage_results<result_type, Monads...>::type>()));
+};
+
+}
+
+/*
+resolves a fixed list of monads over inputs that change little between updates.
+the last input and every monad's last result are kept. an update recomputes from the first monad whose input changed,
+and stops early once a monad's result comes out equal to the cached one. inputs and results have to be equality comparable.
+results that are references (into the input or an earlier result) are never compared, every later monad is recomputed after them.
+*/
+template <typename Input, typename... Monads>
+class incremental_pipeline {
+    static_assert(sizeof...(Monads) > 0, "incremental_pipeline needs at least one monad");
+
+    using results_type = typename detail::stage_results<Input, Monads...>::type;
+    static constexpr std::size_t last = sizeof...(Monads) - 1;
+
+public:
+    using result_type = typename std::tuple_element_t<last, results_type>::value_type;
+
+    explicit incremental_pipeline(Monads... monads) : monads_{std::move(monads)...} {}
+
+    /*
+    returns the result of resolving input through the monads. input is compared to the previous one.
+    if a monad throws, everything cached is dropped and the next update recomputes every monad.
+    */
+    const result_type& update(const Input& input) {
+        recomputed_ = 0;
+        if (input_ && *input_ == input) {
+            return result();
+        }
+        input_ = input;
+        try {
+            recompute(std::index_sequence_for<Monads...>{});
+        } catch (...) {
+            // monads before the one that threw already cached results for the new input, so nothing cached can be trusted.
+            input_.reset();
+            results_ = results_type{};
+            throw;
+        }
+        return result();
+    }
+
+    /*
+    same as above, taking the input as unchanged if version equals the previous one without comparing it.
+    */
+    const result_type& update(const Input& input, std::uint64_t version) {
+        if (input_ && version_ == version) {
+            recomputed_ = 0;
+            return result();
+        }
+        update(input);
+        version_ = version;
+        return result();
+    }
+
+    const result_type& result() const {
+        return *std::get<last>(results_);
+    }
+
+    /*
+    number of monads the last update evaluated.
+    */
+    std::size_t last_recomputed() const noexcept {
+        return recomputed_;
+    }
+
+private:
+    template <std::size_t... I>
+    void recompute(std::index_sequence<I...>) {
+        bool changed = true;
+        (recompute_stage<I>(changed), ...);
+    }
+
+    /*
+    a result referring into the previous result (or the input) refers to storage that was just updated in place,
+    so it compares equal to the cached one whatever changed. such results always count as changed.
+    */
+    template <std::size_t I>
+    void recompute_stage(bool& changed) {
+        if (!changed) {
+            return;
+        }
+
+        auto& cached = std::get<I>(results_);
+        auto result = [this]() {
+            if constexpr (I == 0) {
+                return std::get<I>(monads_)(*input_);
+            } else {
+                return std::get<I>(monads_)(*std::get<I - 1>(results_));
+            }
+        }();
+        ++recomputed_;
+
+        if constexpr (detail::is_reference_wrapper_v<typename decltype(result)::value_type>) {
+            changed = true;
+        } else {
+            changed = !cached || !(*cached == result);
+        }
+        if (changed) {
+            cached.emplace(std::move(result));
+        }
+    }
+
+    std::tuple<Monads...> monads_;
+    std::optional<Input> input_;
+    results_type results_;
+    std::uint64_t version_ = 0;
+    std::size_t recomputed_ = 0;
+};
+
+/*
+returns incremental_pipeline resolving inputs of type Input (an optional) through given monads.
+*/
+template <typename Input, typename... Monads>
+auto make_incremental_pipeline(Monads&&... monads) {
+    return incremental_pipeline<Input, std::decay_t<Monads>...>{std::forward<Monads>(monads)...};
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "monadic_operations.hpp"
+
+/*
+memory mapping of a local file (POSIX). the constructor maps an existing file read-only, create maps a new writable one.
+contents are exposed as a string_view that stays valid for the lifetime of the mapping.
+throws std::system_error if the file can not be opened or mapped.
+*/
+class mapped_file {
+public:
+    explicit mapped_file(const char* path) {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) == -1) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ != 0) {
+            void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), path);
+            }
+            data_ = static_cast<char*>(data);
+            ::madvise(data_, size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+
+    /*
+    creates (or truncates) the file at path to size zero-filled bytes and maps it writable and shared,
+    so writes through writable_data() end up in the file.
+    */
+    static mapped_file create(const char* path, std::size_t size) {
+        const int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+
+        mapped_file file;
+        if (::ftruncate(fd, static_cast<off_t>(size)) == -1) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), path);
+        }
+
+        if (size != 0) {
+            void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), path);
+            }
+            file.data_ = static_cast<char*>(data);
+            file.size_ = size;
+            file.writable_ = true;
+        }
+        ::close(fd);
+        return file;
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& rhs) noexcept
+        : data_{std::exchange(rhs.data_, nullptr)}, size_{std::exchange(rhs.size_, 0)}, writable_{std::exchange(rhs.writable_, false)} {}
+
+    mapped_file& operator=(mapped_file&& rhs) noexcept {
+        if (this != &rhs) {
+            unmap();
+            data_ = std::exchange(rhs.data_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+            writable_ = std::exchange(rhs.writable_, false);
+        }
+        return *this;
+    }
+
+    ~mapped_file() {
+        unmap();
+    }
+
+    std::string_view view() const noexcept {
+        return {data_, size_};
+    }
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    const char* data() const noexcept {
+        return data_;
+    }
+
+    /*
+    start of a mapping made by create, to write through. read-only mappings have none.
+    */
+    char* writable_data() noexcept {
+        assert(writable_ || data_ == nullptr);
+        return data_;
+    }
+
+    /*
+    hints the kernel to start reading [offset, offset + length) in the background.
+    offset should be a multiple of the page size. out of range parts are ignored.
+    */
+    void will_need(std::size_t offset, std::size_t length) const noexcept {
+        if (offset >= size_) {
+            return;
+        }
+        ::madvise(data_ + offset, std::min(length, size_ - offset), MADV_WILLNEED);
+    }
+
+private:
+    mapped_file() = default;
+
+    void unmap() noexcept {
+        if (data_ != nullptr) {
+            ::munmap(data_, size_);
+        }
+    }
+
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool writable_ = false;
+};
+
+/*
+size of the window mapped_file records are read ahead by. a multiple of any common page size.
+*/
+constexpr inline std::size_t record_read_ahead = std::size_t{4} << 20;
+
+/*
+calls given function with every record of data as a string_view into data. no copies are made.
+records are separated by delimiter. a trailing delimiter does not produce an empty last record.
+*/
+template <typename F>
+void for_each_record(std::string_view data, char delimiter, F&& f) {
+    std::size_t begin = 0;
+    while (begin < data.size()) {
+        std::size_t end = data.find(delimiter, begin);
+        if (end == std::string_view::npos) {
+            end = data.size();
+        }
+        f(data.substr(begin, end - begin));
+        begin = end + 1;
+    }
+}
+
+/*
+same as above, reading the mapping ahead in record_read_ahead sized chunks while walking it.
+*/
+template <typename F>
+void for_each_record(const mapped_file& file, char delimiter, F&& f) {
+    const std::string_view data = file.view();
+    std::size_t next_chunk = 0;
+    file.will_need(next_chunk, 2 * record_read_ahead);
+    next_chunk += 2 * record_read_ahead;
+
+    for_each_record(data, delimiter, [&](std::string_view record) {
+        const auto offset = static_cast<std::size_t>(record.data() - data.data());
+        while (offset + record_read_ahead >= next_chunk && next_chunk < data.size()) {
+            file.will_need(next_chunk, record_read_ahead);
+            next_chunk += record_read_ahead;
+        }
+        f(record);
+    });
+}
+
+/*
+resolves every record of the file through given monads and passes each result to sink.
+records are fed in as optional<string_view> pointing into the mapping, so results may keep referring to it
+only as long as the mapped_file is alive.
+*/
+template <typename Sink, typename... Monads>
+void resolve_records(const mapped_file& file, char delimiter, Sink&& sink, Monads&&... monads) {
+    for_each_record(file, delimiter, [&](std::string_view record) {
+        sink(resolve(std::optional<std::string_view>{record}, monads...));
+    });
+}
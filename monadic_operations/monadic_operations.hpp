@@ -1,7 +1,179 @@
 #pragma once 
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+namespace detail {
+
+inline std::pmr::memory_resource*& attached_memory_resource() {
+    thread_local std::pmr::memory_resource* resource = nullptr;
+    return resource;
+}
+
+}
+
+/*
+returns memory resource attached to pipelines resolved on this thread (see memory_resource_scope, resolve_with).
+returns std::pmr::get_default_resource() if none is attached.
+*/
+inline std::pmr::memory_resource* pipeline_memory_resource() {
+    if (auto* resource = detail::attached_memory_resource()) {
+        return resource;
+    }
+    return std::pmr::get_default_resource();
+}
+
+/*
+returns allocator over pipeline_memory_resource(). pass it to allocator-aware values built inside monads
+so they are allocated from the attached resource in the first place.
+*/
+inline std::pmr::polymorphic_allocator<std::byte> pipeline_allocator() {
+    return std::pmr::polymorphic_allocator<std::byte>{pipeline_memory_resource()};
+}
+
+/*
+attaches given memory resource to pipelines resolved on this thread until the scope ends. scopes nest.
+values that transform and or_else build from their functions' results are allocator-aware constructed with it,
+so a per-batch arena (e.g. std::pmr::monotonic_buffer_resource) holds all of them and can be released in one go.
+*/
+class memory_resource_scope {
+public:
+    explicit memory_resource_scope(std::pmr::memory_resource* resource)
+        : previous_{std::exchange(detail::attached_memory_resource(), resource)} {}
+
+    memory_resource_scope(const memory_resource_scope&) = delete;
+    memory_resource_scope& operator=(const memory_resource_scope&) = delete;
+
+    ~memory_resource_scope() {
+        detail::attached_memory_resource() = previous_;
+    }
+
+private:
+    std::pmr::memory_resource* previous_;
+};
+
+namespace detail {
+
+/*
+wraps a monad's result into optional. while a memory resource is attached, results using polymorphic allocators
+are constructed with pipeline_allocator(), which is a plain move when the value already lives in the attached resource.
+without one, results are moved as they are and keep their own resource.
+*/
+template <typename R, typename U>
+std::optional<R> make_optional_result(U&& value) {
+    using Allocator = std::pmr::polymorphic_allocator<std::byte>;
+
+    if constexpr (std::uses_allocator_v<R, Allocator>) {
+        if (attached_memory_resource() != nullptr) {
+            if constexpr (std::is_constructible_v<R, std::allocator_arg_t, const Allocator&, U&&>) {
+                return std::optional<R>{std::in_place, std::allocator_arg, pipeline_allocator(), std::forward<U>(value)};
+            } else if constexpr (std::is_constructible_v<R, U&&, const Allocator&>) {
+                return std::optional<R>{std::in_place, std::forward<U>(value), pipeline_allocator()};
+            }
+        }
+    }
+    return std::optional<R>{std::forward<U>(value)};
+}
+
+}
+
+template <typename T>
+constexpr inline bool is_optional_v = false;
+
+template <typename T>
+constexpr inline bool is_optional_v<std::optional<T>> = true;
+
+template <typename T>
+using is_optional = std::bool_constant<is_optional_v<T>>;
+
+namespace detail {
+
+/*
+optionals of small trivially copyable values fit into registers, so monads take them by value.
+*/
+template <typename T>
+constexpr inline bool is_register_sized_v = std::is_trivially_copyable_v<T> && sizeof(std::optional<T>) <= 2 * sizeof(void*);
+
+/*
+adds a by-value overload to a monad for optionals the Policy says can not tell the difference.
+everything else is forwarded by reference to the monad as before.
+*/
+template <typename Monad, typename Policy>
+struct by_value_monad : Monad {
+    template <typename X>
+    static constexpr bool takes_by_value() {
+        if constexpr (is_optional_v<X>) {
+            if constexpr (is_register_sized_v<typename X::value_type>) {
+                return Policy::template eligible<typename X::value_type>();
+            } else {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    template <typename X, std::enable_if_t<!takes_by_value<std::remove_cv_t<std::remove_reference_t<X>>>(), int> = 0>
+    auto operator()(X&& x) const -> decltype(auto) {
+        return Monad::operator()(std::forward<X>(x));
+    }
+
+    template <typename T, std::enable_if_t<takes_by_value<std::optional<T>>(), int> = 0>
+    auto operator()(std::optional<T> x) const -> decltype(auto) {
+        return Monad::operator()(std::move(x));
+    }
+};
+
+template <typename Policy, typename Monad>
+by_value_monad<Monad, Policy> take_small_by_value(Monad&& monad) {
+    return {std::forward<Monad>(monad)};
+}
+
+/*
+a copy is indistinguishable when the function takes the value as rvalue and does not return a reference (possibly into it).
+*/
+template <typename F>
+struct invoke_by_value_policy {
+    template <typename T>
+    static constexpr bool eligible() {
+        if constexpr (std::is_invocable_v<const F&, T&&>) {
+            return !std::is_reference_v<std::invoke_result_t<const F&, T&&>>;
+        } else {
+            return false;
+        }
+    }
+};
+
+template <typename F>
+struct fallback_by_value_policy {
+    template <typename T>
+    static constexpr bool eligible() {
+        return !std::is_reference_v<std::invoke_result_t<const F&>>;
+    }
+};
+
+template <typename F>
+struct predicate_by_value_policy {
+    template <typename T>
+    static constexpr bool eligible() {
+        return std::is_invocable_v<const F&, const T&>;
+    }
+};
+
+}
 
 /*
 returns function that wraps given function. given function should return a value or a reference to a value.
@@ -10,7 +182,7 @@ returned function returns value from original function wrapped into optional if
 */
 template <typename F>
 auto transform(F&& f) {
-    return [f = std::forward<F>(f)](auto&& x) {
+    return detail::take_small_by_value<detail::invoke_by_value_policy<std::decay_t<F>>>([f = std::forward<F>(f)](auto&& x) {
         using ResultType = decltype(f(std::forward<decltype(x)>(x).value()));
         using OptionalResultType = std::conditional_t<
             std::is_reference_v<ResultType> && !std::is_rvalue_reference_v<ResultType>,
@@ -18,10 +190,10 @@ auto transform(F&& f) {
             std::remove_reference_t<ResultType>>;
 
         if (x.has_value()) {
-            return std::optional<OptionalResultType>{f(*std::forward<decltype(x)>(x))};
+            return detail::make_optional_result<OptionalResultType>(f(*std::forward<decltype(x)>(x)));
         }
         return std::optional<OptionalResultType>{};
-    };
+    });
 }
 
 /*
@@ -32,7 +204,7 @@ if original function returns reference to an optional, the result will be option
 */
 template <typename F>
 auto and_then(F&& f) {
-    return [f = std::forward<F>(f)](auto&& x) {
+    return detail::take_small_by_value<detail::invoke_by_value_policy<std::decay_t<F>>>([f = std::forward<F>(f)](auto&& x) {
         using ResultType = decltype(f(std::forward<decltype(x)>(x).value()));
         using OptionalValueType = std::remove_reference_t<decltype(f(std::forward<decltype(x)>(x).value()).value())>;
         using OptionalValueResultType = std::conditional_t<
@@ -52,19 +224,10 @@ auto and_then(F&& f) {
         }
 
         return std::optional<OptionalValueResultType>{};
-    };
+    });
     
 }
 
-template <typename T>
-constexpr inline bool is_optional_v = false;
-
-template <typename T>
-constexpr inline bool is_optional_v<std::optional<T>> = true;
-
-template <typename T>
-using is_optional = std::bool_constant<is_optional_v<T>>;
-
 /*
 returns function that wraps given function. given function should return a value, or a reference to a value, or an optional or reference to an optional.
 returned function takes optional<T>.
@@ -74,10 +237,10 @@ if original function returns reference to an optional, the result will be option
 */
 template <typename F>
 auto or_else(F&& f) -> decltype(auto)  {
-    return [f = std::forward<F>(f)](auto&& x) -> decltype(auto) {
+    return detail::take_small_by_value<detail::fallback_by_value_policy<std::decay_t<F>>>([f = std::forward<F>(f)](auto&& x) -> decltype(auto) {
         using ResultType = decltype(f());
 
-        if constexpr (is_optional_v<std::remove_reference_t<ResultType>>) {
+        if constexpr (is_optional_v<std::remove_cv_t<std::remove_reference_t<ResultType>>>) {
             using OptionalValueResultType = std::conditional_t<
                 std::is_reference_v<ResultType> && !std::is_rvalue_reference_v<ResultType>,
                 std::reference_wrapper<std::remove_reference_t<decltype(f().value())>>,
@@ -102,6 +265,14 @@ auto or_else(F&& f) -> decltype(auto)  {
                     if (x.has_value()) {
                         return std::optional<OptionalValueResultType>{*std::forward<decltype(x)>(x)};
                     }
+                    if constexpr (std::uses_allocator_v<OptionalValueResultType, std::pmr::polymorphic_allocator<std::byte>>) {
+                        if (detail::attached_memory_resource() != nullptr) {
+                            if (auto result = f()) {
+                                return detail::make_optional_result<OptionalValueResultType>(*std::move(result));
+                            }
+                            return std::optional<OptionalValueResultType>{};
+                        }
+                    }
                     return f();
                 }
             }
@@ -114,14 +285,14 @@ auto or_else(F&& f) -> decltype(auto)  {
             if (x.has_value()) {
                 return std::optional<OptionalValueResultType>{*std::forward<decltype(x)>(x)};
             }
-            return std::optional<OptionalValueResultType>{f()};
+            return detail::make_optional_result<OptionalValueResultType>(f());
         }
-    };
+    });
 }
 
 template <typename F>
 auto filter(F&& f) {
-    return [f = std::forward<F>(f)](auto&& x) {
+    return detail::take_small_by_value<detail::predicate_by_value_policy<std::decay_t<F>>>([f = std::forward<F>(f)](auto&& x) {
         if (x.has_value()) {
             if (f(*x)) {
                 return std::forward<decltype(x)>(x);
@@ -129,7 +300,161 @@ auto filter(F&& f) {
         }
 
         return std::optional<std::remove_reference_t<decltype(std::forward<decltype(x)>(x).value())>>{}; 
+    });
+}
+
+/*
+filter_all measures every predicate on one in filter_all_sample_interval elements,
+and reorders the predicates every filter_all_reorder_interval elements.
+*/
+constexpr inline std::size_t filter_all_sample_interval = 64;
+constexpr inline std::size_t filter_all_reorder_interval = 4096;
+
+template <bool Adaptive, typename... Predicates>
+class filter_all_monad {
+public:
+    static constexpr std::size_t size = sizeof...(Predicates);
+
+    filter_all_monad(std::array<std::size_t, size> order, Predicates... predicates)
+        : predicates_{std::move(predicates)...}, order_{order} {}
+
+    template <typename X>
+    auto operator()(X&& x) const {
+        using OptionalResultType = std::optional<std::remove_cv_t<std::remove_reference_t<decltype(std::forward<X>(x).value())>>>;
+
+        if (x.has_value()) {
+            if (passes(*x)) {
+                return OptionalResultType{std::forward<X>(x)};
+            }
+        }
+        return OptionalResultType{};
+    }
+
+    /*
+    indices of the predicates in the order they are currently evaluated in.
+    */
+    const std::array<std::size_t, size>& evaluation_order() const noexcept {
+        return order_;
+    }
+
+private:
+    struct predicate_stats {
+        std::uint64_t evaluated = 0;
+        std::uint64_t passed = 0;
+        std::chrono::steady_clock::duration cost{};
     };
+
+    template <typename V>
+    bool passes(V& value) const {
+        if constexpr (Adaptive) {
+            ++seen_;
+            if (seen_ % filter_all_reorder_interval == 0) {
+                reorder();
+            }
+            if (seen_ % filter_all_sample_interval == 0) {
+                return sample(value);
+            }
+        }
+
+        for (auto index : order_) {
+            if (!evaluate(index, value, std::index_sequence_for<Predicates...>{})) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename V, std::size_t... I>
+    bool evaluate(std::size_t index, V& value, std::index_sequence<I...>) const {
+        bool result = false;
+        ((index == I && (result = static_cast<bool>(std::get<I>(predicates_)(value)), true)) || ...);
+        return result;
+    }
+
+    /*
+    evaluates the predicates in order and stops at the first rejection, like the unsampled path.
+    pass rates are therefore measured on the elements that got past the predicates before.
+    */
+    template <typename V>
+    bool sample(V& value) const {
+        for (auto index : order_) {
+            const auto start = std::chrono::steady_clock::now();
+            const bool passed = evaluate(index, value, std::index_sequence_for<Predicates...>{});
+            stats_[index].cost += std::chrono::steady_clock::now() - start;
+            ++stats_[index].evaluated;
+            stats_[index].passed += passed ? 1 : 0;
+            if (!passed) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+    sorts predicates by cost / (1 - pass rate), which minimizes expected cost per element for independent predicates.
+    nothing is reordered until every predicate has been sampled at least once.
+    stats are halved afterwards so older samples fade out.
+    */
+    void reorder() const {
+        std::array<double, size> rank{};
+        for (std::size_t i = 0; i < size; ++i) {
+            if (stats_[i].evaluated == 0) {
+                return;
+            }
+            const double cost = static_cast<double>(stats_[i].cost.count()) / static_cast<double>(stats_[i].evaluated);
+            const double rejection = 1.0 - static_cast<double>(stats_[i].passed) / static_cast<double>(stats_[i].evaluated);
+            rank[i] = cost / std::max(rejection, 1e-6);
+        }
+
+        std::stable_sort(order_.begin(), order_.end(), [&rank](std::size_t lhs, std::size_t rhs) { return rank[lhs] < rank[rhs]; });
+
+        for (auto& stats : stats_) {
+            stats.evaluated /= 2;
+            stats.passed /= 2;
+            stats.cost /= 2;
+        }
+    }
+
+    std::tuple<Predicates...> predicates_;
+    mutable std::array<std::size_t, size> order_;
+    mutable std::array<predicate_stats, size> stats_{};
+    mutable std::size_t seen_ = 0;
+};
+
+namespace detail {
+
+template <std::size_t N>
+constexpr std::array<std::size_t, N> identity_order() {
+    std::array<std::size_t, N> order{};
+    for (std::size_t i = 0; i < N; ++i) {
+        order[i] = i;
+    }
+    return order;
+}
+
+}
+
+/*
+returns function that works like a chain of filter with given predicates. returned function takes optional<T>.
+returned function returns input if it has value and every predicate returns true for it, nullopt otherwise.
+predicates are evaluated in the order that minimizes expected cost per element, based on pass rates and costs sampled at runtime,
+and evaluation stops at the first one that returns false. since that order may be any order, every predicate has to be safe
+to call on any engaged value: a predicate can not rely on an earlier one to guard it, as it could in a chain of filter.
+the monad keeps its measurements in itself without allocating. it must not be shared between threads.
+*/
+template <typename... Predicates>
+auto filter_all(Predicates&&... predicates) {
+    return filter_all_monad<true, std::decay_t<Predicates>...>{
+        detail::identity_order<sizeof...(Predicates)>(), std::forward<Predicates>(predicates)...};
+}
+
+/*
+same as filter_all, with a fixed evaluation order instead of a measured one. order lists predicate indices, first evaluated first.
+*/
+template <typename... Predicates>
+auto filter_all_ordered(const std::array<std::size_t, sizeof...(Predicates)>& order, Predicates&&... predicates) {
+    assert(std::is_permutation(order.begin(), order.end(), detail::identity_order<sizeof...(Predicates)>().begin()));
+    return filter_all_monad<false, std::decay_t<Predicates>...>{order, std::forward<Predicates>(predicates)...};
 }
 
 template <typename T, typename Monad>
@@ -142,3 +467,402 @@ auto resolve(T&& maybe_value, Monad&& monad, Monads&&... monads) -> decltype(aut
     return resolve(std::forward<Monad>(monad)(std::forward<T>(maybe_value)), std::forward<Monads>(monads)...);
 }
 
+/*
+same as resolve, with given memory resource attached to the pipeline for the duration of the call (see memory_resource_scope).
+*/
+template <typename T, typename... Monads>
+auto resolve_with(std::pmr::memory_resource* resource, T&& maybe_value, Monads&&... monads) -> decltype(auto) {
+    memory_resource_scope scope{resource};
+    return resolve(std::forward<T>(maybe_value), std::forward<Monads>(monads)...);
+}
+
+/*
+returns function that wraps given function. given function should return a value convertible to T.
+returned function takes optional<T>.
+returned function returns the value of input if input has value, the result of the original function otherwise.
+unlike optional::value_or the fallback is only built when it is needed. meant as the last monad of a resolve call.
+*/
+template <typename F>
+auto value_or_else(F&& f) {
+    return [f = std::forward<F>(f)](auto&& x) {
+        using ValueType = std::remove_cv_t<std::remove_reference_t<decltype(*std::forward<decltype(x)>(x))>>;
+
+        if (x.has_value()) {
+            return ValueType(*std::forward<decltype(x)>(x));
+        }
+        return ValueType(f());
+    };
+}
+
+namespace detail {
+
+template <typename T, typename = void>
+constexpr inline bool is_iterator_v = false;
+
+template <typename T>
+constexpr inline bool is_iterator_v<T, std::void_t<typename std::iterator_traits<T>::iterator_category>> = true;
+
+}
+
+/*
+resolves maybe_value through given monads and writes the result straight into out. returns true if the result has value.
+out is either
+- an output iterator: the value is written and the iterator advanced only if the result has value,
+- an optional: it is assigned the result, empty or not,
+- any other object: it is assigned the value only if the result has value.
+the final optional is not copied or moved on the way, only its value is moved into out.
+*/
+template <typename Out, typename T, typename... Monads>
+bool resolve_into(Out&& out, T&& maybe_value, Monads&&... monads) {
+    auto&& result = resolve(std::forward<T>(maybe_value), std::forward<Monads>(monads)...);
+    using ResultType = decltype(result);
+
+    if constexpr (is_optional_v<std::remove_cv_t<std::remove_reference_t<Out>>>) {
+        if (result.has_value()) {
+            out = *std::forward<ResultType>(result);
+            return true;
+        }
+        out.reset();
+        return false;
+    } else {
+        if (!result.has_value()) {
+            return false;
+        }
+        if constexpr (detail::is_iterator_v<std::remove_cv_t<std::remove_reference_t<Out>>>) {
+            *out = *std::forward<ResultType>(result);
+            ++out;
+        } else {
+            out = *std::forward<ResultType>(result);
+        }
+        return true;
+    }
+}
+
+namespace detail {
+
+template <typename Monad, typename Column, typename = void>
+constexpr inline bool has_apply_batch_v = false;
+
+template <typename Monad, typename Column>
+constexpr inline bool has_apply_batch_v<Monad, Column,
+    std::void_t<decltype(std::declval<Monad&>().apply_batch(std::declval<Column>()))>> = true;
+
+template <typename Monad, typename T>
+auto apply_to_column(Monad& monad, std::vector<T>& column) {
+    if constexpr (has_apply_batch_v<Monad, std::vector<T>&&>) {
+        return monad.apply_batch(std::move(column));
+    } else {
+        std::vector<std::decay_t<decltype(monad(std::move(column.front())))>> result;
+        result.reserve(column.size());
+        for (auto& x : column) {
+            result.push_back(monad(std::move(x)));
+        }
+        return result;
+    }
+}
+
+/*
+every column stays alive until the last one is written out, so results may refer into earlier columns.
+*/
+template <typename Column, typename OutputIt>
+OutputIt resolve_column(Column& column, OutputIt out) {
+    return std::move(column.begin(), column.end(), out);
+}
+
+template <typename Column, typename OutputIt, typename Monad, typename... Monads>
+OutputIt resolve_column(Column& column, OutputIt out, Monad& monad, Monads&... monads) {
+    auto next = apply_to_column(monad, column);
+    return resolve_column(next, out, monads...);
+}
+
+/*
+the first monad is applied to the input elements themselves, as resolve would be. only batching monads get a copy of the range.
+*/
+template <typename InputIt, typename OutputIt, typename Monad, typename... Monads>
+OutputIt resolve_range(InputIt first, InputIt last, OutputIt out, Monad& monad, Monads&... monads) {
+    using InputType = std::decay_t<typename std::iterator_traits<InputIt>::reference>;
+
+    if constexpr (has_apply_batch_v<Monad, std::vector<InputType>&&>) {
+        std::vector<InputType> inputs(first, last);
+        auto column = apply_to_column(monad, inputs);
+        return resolve_column(column, out, monads...);
+    } else {
+        std::vector<std::decay_t<decltype(monad(*first))>> column;
+        for (; first != last; ++first) {
+            column.push_back(monad(*first));
+        }
+        return resolve_column(column, out, monads...);
+    }
+}
+
+}
+
+/*
+resolves every optional in [first, last) through given monads and writes the results to out. returns out past the last result.
+monads are applied one at a time over the whole range, so batching monads like batched_and_then see every input at once.
+plain monads behave exactly as in resolve, and results referring into the inputs or into earlier results stay valid until they are written.
+*/
+template <typename InputIt, typename OutputIt, typename... Monads>
+OutputIt resolve_all(InputIt first, InputIt last, OutputIt out, Monads&&... monads) {
+    if constexpr (sizeof...(Monads) == 0) {
+        return std::copy(first, last, out);
+    } else {
+        return detail::resolve_range(first, last, out, monads...);
+    }
+}
+
+template <typename F>
+struct batched_and_then_monad {
+    F f;
+    std::size_t batch_size;
+
+    template <typename T>
+    using key_batch = std::vector<std::remove_cv_t<std::remove_reference_t<T>>>;
+
+    template <typename X>
+    auto operator()(X&& x) const {
+        key_batch<decltype(*std::forward<X>(x))> keys;
+        using BatchResultType = decltype(f(keys));
+        using OptionalResultType = std::decay_t<decltype(*std::declval<BatchResultType&>().begin())>;
+
+        if (x.has_value()) {
+            keys.push_back(*std::forward<X>(x));
+            auto results = f(keys);
+            assert(results.size() == 1);
+            return OptionalResultType{std::move(*results.begin())};
+        }
+        return OptionalResultType{};
+    }
+
+    template <typename T>
+    auto apply_batch(std::vector<std::optional<T>>&& column) const {
+        key_batch<T> keys;
+        using BatchResultType = decltype(f(keys));
+        using OptionalResultType = std::decay_t<decltype(*std::declval<BatchResultType&>().begin())>;
+
+        std::vector<OptionalResultType> results(column.size());
+        std::vector<std::size_t> positions;
+        const std::size_t size = batch_size == 0 ? 1 : batch_size;
+        keys.reserve(size);
+        positions.reserve(size);
+
+        auto flush = [&]() {
+            if (keys.empty()) {
+                return;
+            }
+            auto batch_results = f(keys);
+            assert(static_cast<std::size_t>(std::distance(batch_results.begin(), batch_results.end())) == keys.size());
+
+            auto position = positions.begin();
+            for (auto& result : batch_results) {
+                results[*position++] = std::move(result);
+            }
+            keys.clear();
+            positions.clear();
+        };
+
+        for (std::size_t i = 0; i < column.size(); ++i) {
+            if (column[i].has_value()) {
+                keys.push_back(*std::move(column[i]));
+                positions.push_back(i);
+                if (keys.size() == size) {
+                    flush();
+                }
+            }
+        }
+        flush();
+
+        return results;
+    }
+};
+
+/*
+returns monad that looks up values for many keys at once. given function takes a vector of keys and returns
+a container with an optional result for every key, in the same order.
+over a single optional (resolve) given function is called with one key if input has value, and not at all otherwise.
+over a range (resolve_all) engaged inputs are collected into batches of up to batch_size keys, given function is called
+once per batch and results are scattered back to the positions of their inputs. empty inputs never reach given function.
+*/
+template <typename F>
+auto batched_and_then(F&& f, std::size_t batch_size) {
+    return batched_and_then_monad<std::decay_t<F>>{std::forward<F>(f), batch_size};
+}
+
+namespace detail {
+
+inline void prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+template <typename Container, typename = void>
+constexpr inline bool has_find_v = false;
+
+template <typename Container>
+constexpr inline bool has_find_v<Container,
+    std::void_t<decltype(std::declval<Container&>().find(std::declval<const typename Container::key_type&>()))>> = true;
+
+template <typename Container, typename = void>
+constexpr inline bool has_buckets_v = false;
+
+template <typename Container>
+constexpr inline bool has_buckets_v<Container,
+    std::void_t<decltype(std::declval<Container&>().begin(std::declval<Container&>().bucket(std::declval<const typename Container::key_type&>()))),
+                decltype(std::declval<Container&>().key_eq())>> = true;
+
+}
+
+/*
+number of keys lookup works ahead of the probe it is currently doing when used over a range.
+*/
+constexpr inline std::size_t lookup_prefetch_distance = 8;
+
+template <typename Container>
+struct lookup_monad {
+    Container* container;
+
+    using value_type = std::remove_reference_t<decltype((std::declval<Container&>().begin()->second))>;
+    using result_type = std::optional<std::reference_wrapper<value_type>>;
+
+    template <typename X>
+    result_type operator()(X&& x) const {
+        if (x.has_value()) {
+            return find(*x);
+        }
+        return result_type{};
+    }
+
+    template <typename T>
+    std::vector<result_type> apply_batch(std::vector<std::optional<T>>&& column) const {
+        std::vector<result_type> results(column.size());
+
+        std::vector<std::size_t> positions;
+        positions.reserve(column.size());
+        for (std::size_t i = 0; i < column.size(); ++i) {
+            if (column[i].has_value()) {
+                positions.push_back(i);
+            }
+        }
+
+        if constexpr (detail::has_buckets_v<Container>) {
+            find_hashed(column, positions, results);
+        } else if constexpr (detail::has_find_v<Container>) {
+            for (auto position : positions) {
+                results[position] = find(*column[position]);
+            }
+        } else {
+            find_sorted(column, positions, results);
+        }
+        return results;
+    }
+
+private:
+    template <typename Key>
+    result_type find(const Key& key) const {
+        if constexpr (detail::has_find_v<Container>) {
+            auto it = container->find(key);
+            if (it != container->end()) {
+                return result_type{it->second};
+            }
+        } else {
+            auto it = std::lower_bound(container->begin(), container->end(), key,
+                [](const auto& entry, const Key& k) { return entry.first < k; });
+            if (it != container->end() && !(key < it->first)) {
+                return result_type{it->second};
+            }
+        }
+        return result_type{};
+    }
+
+    /*
+    buckets of the next keys are computed and their first node prefetched before the current key is probed.
+    only that node is prefetched: getting to it through begin(bucket) reads the bucket array (and, in libstdc++,
+    the node before the bucket) right away, since the standard interface offers no address to prefetch those.
+    probing walks the bucket directly, so every key is hashed only once.
+    */
+    template <typename Column>
+    void find_hashed(const Column& column, const std::vector<std::size_t>& positions, std::vector<result_type>& results) const {
+        std::size_t buckets[lookup_prefetch_distance];
+
+        auto issue = [&](std::size_t i) {
+            const auto& key = *column[positions[i]];
+            const auto bucket = container->bucket(key);
+            buckets[i % lookup_prefetch_distance] = bucket;
+            const auto node = container->begin(bucket);
+            if (node != container->end(bucket)) {
+                detail::prefetch(&*node);
+            }
+        };
+
+        for (std::size_t i = 0; i < std::min(lookup_prefetch_distance, positions.size()); ++i) {
+            issue(i);
+        }
+
+        for (std::size_t i = 0; i < positions.size(); ++i) {
+            const auto& key = *column[positions[i]];
+            const auto bucket = buckets[i % lookup_prefetch_distance];
+            for (auto it = container->begin(bucket); it != container->end(bucket); ++it) {
+                if (container->key_eq()(it->first, key)) {
+                    results[positions[i]] = result_type{it->second};
+                    break;
+                }
+            }
+
+            if (i + lookup_prefetch_distance < positions.size()) {
+                issue(i + lookup_prefetch_distance);
+            }
+        }
+    }
+
+    /*
+    binary searches of lookup_prefetch_distance keys advance in lockstep. every search prefetches its next probe,
+    which is only read after all other searches of the group made their step.
+    */
+    template <typename Column>
+    void find_sorted(const Column& column, const std::vector<std::size_t>& positions, std::vector<result_type>& results) const {
+        const auto first = container->begin();
+        const auto size = static_cast<std::size_t>(std::distance(first, container->end()));
+        if (size == 0) {
+            return;
+        }
+
+        for (std::size_t group = 0; group < positions.size(); group += lookup_prefetch_distance) {
+            const std::size_t count = std::min(lookup_prefetch_distance, positions.size() - group);
+            std::size_t base[lookup_prefetch_distance] = {};
+
+            for (std::size_t n = size; n > 1;) {
+                const std::size_t half = n / 2;
+                const std::size_t next_half = (n - half) / 2;
+                for (std::size_t g = 0; g < count; ++g) {
+                    const auto& key = *column[positions[group + g]];
+                    base[g] = first[base[g] + half].first < key ? base[g] + half : base[g];
+                    detail::prefetch(&first[base[g] + next_half]);
+                }
+                n -= half;
+            }
+
+            for (std::size_t g = 0; g < count; ++g) {
+                const auto& key = *column[positions[group + g]];
+                const std::size_t index = base[g] + (first[base[g]].first < key ? 1 : 0);
+                if (index < size && !(key < first[index].first)) {
+                    results[positions[group + g]] = result_type{first[index].second};
+                }
+            }
+        }
+    }
+};
+
+/*
+returns monad that looks up the input value as a key in given container and returns optional to reference to the mapped value,
+nullopt if input has no value or the key is not found. container is referenced, not copied, and has to outlive the results.
+container is either associative (map, unordered_map, flat maps), or a range of key-value pairs sorted by key.
+when used over a range (resolve_all), lookups of the next lookup_prefetch_distance keys are started ahead of the current one:
+sorted ranges prefetch every binary search probe, hashed containers prefetch the first node of each key's bucket.
+*/
+template <typename Container>
+auto lookup(Container& container) {
+    return lookup_monad<Container>{&container};
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "mapped_file.hpp"
+
+/*
+on-disk layout of a column of optional<T>, in native byte order:
+- header (optional_column_header) at offset 0,
+- validity bitmap at validity_offset, one bit per element (least significant bit first) in 64-bit words,
+- dense values at values_offset, one T per element. values of empty elements are unspecified.
+both sections start on a 64 byte boundary, so a mapping can be used in place.
+*/
+struct optional_column_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t type_code;
+    std::uint32_t value_size;
+    std::uint32_t value_alignment;
+    std::uint64_t length;
+    std::uint64_t validity_offset;
+    std::uint64_t values_offset;
+};
+
+constexpr inline char optional_column_magic[8] = {'M', 'O', 'P', 'C', 'O', 'L', '\0', '\0'};
+constexpr inline std::uint32_t optional_column_version = 1;
+constexpr inline std::size_t optional_column_alignment = 64;
+
+/*
+identifies the value type of a column: its kind (signed, unsigned, floating point, bool or other) and size.
+*/
+template <typename T>
+constexpr std::uint32_t optional_column_type_code() {
+    std::uint32_t kind = 0;
+    if constexpr (std::is_same_v<T, bool>) {
+        kind = 4;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        kind = 3;
+    } else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T>) {
+        kind = 2;
+    } else if constexpr (std::is_integral_v<T>) {
+        kind = 1;
+    }
+    return kind << 16 | static_cast<std::uint32_t>(sizeof(T));
+}
+
+namespace detail {
+
+constexpr std::size_t align_up(std::size_t offset, std::size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/*
+returns length if a column file of that many elements has a size that fits in std::size_t, throws std::length_error otherwise.
+*/
+template <typename T>
+std::size_t checked_column_length(std::size_t length) {
+    constexpr std::size_t max = std::numeric_limits<std::size_t>::max();
+    const std::size_t validity_offset = align_up(sizeof(optional_column_header), optional_column_alignment);
+    const std::size_t words = length / 64 + (length % 64 != 0 ? 1 : 0);
+
+    if (words > (max - validity_offset - optional_column_alignment) / sizeof(std::uint64_t)) {
+        throw std::length_error("optional column too long");
+    }
+    const std::size_t values_offset = align_up(validity_offset + words * sizeof(std::uint64_t), optional_column_alignment);
+    if (length > (max - values_offset) / sizeof(T)) {
+        throw std::length_error("optional column too long");
+    }
+    return length;
+}
+
+template <typename T>
+optional_column_header make_column_header(std::size_t length) {
+    optional_column_header header{};
+    std::memcpy(header.magic, optional_column_magic, sizeof(header.magic));
+    header.version = optional_column_version;
+    header.type_code = optional_column_type_code<T>();
+    header.value_size = sizeof(T);
+    header.value_alignment = alignof(T);
+    header.length = length;
+    header.validity_offset = align_up(sizeof(optional_column_header), optional_column_alignment);
+    header.values_offset = align_up(header.validity_offset + (length + 63) / 64 * sizeof(std::uint64_t), optional_column_alignment);
+    return header;
+}
+
+}
+
+/*
+read-only view of an optional<T> column file, mapped in place. elements are read straight from the mapping.
+throws std::system_error if the file can not be mapped, std::runtime_error if it is not a column of T.
+*/
+template <typename T>
+class optional_column_view {
+    static_assert(std::is_trivially_copyable_v<T>, "optional columns hold trivially copyable values");
+    static_assert(alignof(T) <= optional_column_alignment, "optional column values are aligned to 64 bytes at most");
+
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::optional<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::optional<T>;
+
+        iterator(const optional_column_view* view, std::size_t index) : view_{view}, index_{index} {}
+
+        std::optional<T> operator*() const {
+            return (*view_)[index_];
+        }
+
+        iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto previous = *this;
+            ++index_;
+            return previous;
+        }
+
+        bool operator==(const iterator& rhs) const {
+            return index_ == rhs.index_;
+        }
+
+        bool operator!=(const iterator& rhs) const {
+            return index_ != rhs.index_;
+        }
+
+    private:
+        const optional_column_view* view_;
+        std::size_t index_;
+    };
+
+    explicit optional_column_view(const char* path) : file_{path} {
+        if (file_.size() < sizeof(optional_column_header)) {
+            throw std::runtime_error(std::string{path} + ": not an optional column");
+        }
+
+        optional_column_header header;
+        std::memcpy(&header, file_.data(), sizeof(header));
+
+        if (std::memcmp(header.magic, optional_column_magic, sizeof(header.magic)) != 0 || header.version != optional_column_version) {
+            throw std::runtime_error(std::string{path} + ": not an optional column");
+        }
+        if (header.type_code != optional_column_type_code<T>() || header.value_size != sizeof(T) || header.value_alignment != alignof(T)) {
+            throw std::runtime_error(std::string{path} + ": optional column of a different type");
+        }
+        if (!fits(header)) {
+            throw std::runtime_error(std::string{path} + ": truncated optional column");
+        }
+
+        size_ = static_cast<std::size_t>(header.length);
+        validity_ = reinterpret_cast<const std::uint64_t*>(file_.data() + header.validity_offset);
+        values_ = reinterpret_cast<const T*>(file_.data() + header.values_offset);
+        file_.will_need(0, file_.size());
+    }
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    bool has_value(std::size_t index) const noexcept {
+        return (validity_[index / 64] >> (index % 64)) & 1;
+    }
+
+    std::optional<T> operator[](std::size_t index) const {
+        if (has_value(index)) {
+            return values_[index];
+        }
+        return std::nullopt;
+    }
+
+    /*
+    raw sections of the mapping, for consumers that process whole words of the bitmap at once.
+    */
+    const std::uint64_t* validity() const noexcept {
+        return validity_;
+    }
+
+    const T* values() const noexcept {
+        return values_;
+    }
+
+    iterator begin() const {
+        return iterator{this, 0};
+    }
+
+    iterator end() const {
+        return iterator{this, size_};
+    }
+
+private:
+    /*
+    checks the sections against the file size by division, so a corrupt length can not wrap the offsets around.
+    */
+    bool fits(const optional_column_header& header) const {
+        const std::uint64_t file_size = file_.size();
+        const std::uint64_t validity_offset = detail::align_up(sizeof(optional_column_header), optional_column_alignment);
+        if (header.validity_offset != validity_offset || file_size < validity_offset) {
+            return false;
+        }
+
+        const std::uint64_t words = header.length / 64 + (header.length % 64 != 0 ? 1 : 0);
+        if (words > (file_size - validity_offset) / sizeof(std::uint64_t)) {
+            return false;
+        }
+
+        const auto expected = detail::make_column_header<T>(static_cast<std::size_t>(header.length));
+        if (header.values_offset != expected.values_offset || file_size < header.values_offset) {
+            return false;
+        }
+        return header.length <= (file_size - header.values_offset) / sizeof(T);
+    }
+
+    mapped_file file_;
+    std::size_t size_ = 0;
+    const std::uint64_t* validity_ = nullptr;
+    const T* values_ = nullptr;
+};
+
+/*
+creates an optional<T> column file of given length and maps it writable. all elements start out empty.
+elements are written straight into the mapping, either by set or through the output iterator returned by begin.
+throws std::length_error if the file would be larger than std::size_t can address.
+*/
+template <typename T>
+class optional_column_writer {
+    static_assert(std::is_trivially_copyable_v<T>, "optional columns hold trivially copyable values");
+    static_assert(alignof(T) <= optional_column_alignment, "optional column values are aligned to 64 bytes at most");
+
+public:
+    class iterator {
+    public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        iterator(optional_column_writer* writer, std::size_t index) : writer_{writer}, index_{index} {}
+
+        iterator& operator*() {
+            return *this;
+        }
+
+        template <typename U>
+        iterator& operator=(U&& value) {
+            writer_->set(index_, std::forward<U>(value));
+            return *this;
+        }
+
+        iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto previous = *this;
+            ++index_;
+            return previous;
+        }
+
+    private:
+        optional_column_writer* writer_;
+        std::size_t index_;
+    };
+
+    optional_column_writer(const char* path, std::size_t length)
+        : header_{detail::make_column_header<T>(detail::checked_column_length<T>(length))},
+          file_{mapped_file::create(path, header_.values_offset + length * sizeof(T))} {
+        std::memcpy(file_.writable_data(), &header_, sizeof(header_));
+        validity_ = reinterpret_cast<std::uint64_t*>(file_.writable_data() + header_.validity_offset);
+        values_ = reinterpret_cast<T*>(file_.writable_data() + header_.values_offset);
+    }
+
+    std::size_t size() const noexcept {
+        return static_cast<std::size_t>(header_.length);
+    }
+
+    template <typename U>
+    void set(std::size_t index, const std::optional<U>& value) {
+        if (value.has_value()) {
+            set(index, *value);
+        } else {
+            validity_[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+        }
+    }
+
+    template <typename U, std::enable_if_t<!is_optional_v<std::decay_t<U>>, int> = 0>
+    void set(std::size_t index, U&& value) {
+        values_[index] = static_cast<T>(std::forward<U>(value));
+        validity_[index / 64] |= std::uint64_t{1} << (index % 64);
+    }
+
+    iterator begin() {
+        return iterator{this, 0};
+    }
+
+private:
+    optional_column_header header_;
+    mapped_file file_;
+    std::uint64_t* validity_ = nullptr;
+    T* values_ = nullptr;
+};
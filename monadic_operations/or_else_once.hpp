@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "monadic_operations.hpp"
+
+namespace detail {
+
+/*
+result of a function computed on first use, at most once across threads. once computed it is read without locking.
+if the function throws, nothing is stored and the next use tries again.
+*/
+template <typename F>
+class computed_once {
+public:
+    using value_type = std::decay_t<std::invoke_result_t<F&>>;
+
+    explicit computed_once(F f) : f_{std::move(f)} {}
+
+    const value_type& get() {
+        if (!ready_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (!value_) {
+                value_.emplace(f_());
+                ready_.store(true, std::memory_order_release);
+            }
+        }
+        return *value_;
+    }
+
+private:
+    F f_;
+    std::optional<value_type> value_;
+    std::mutex mutex_;
+    std::atomic<bool> ready_{false};
+};
+
+}
+
+/*
+returns or_else monad whose given function is called at most once, the first time an input has no value, across all threads
+using the monad or its copies. given function should return a value or an optional.
+for an lvalue input the result is optional to (const) reference, either to the stored result or to the input value,
+so the input has to outlive the result.
+for an rvalue input (e.g. the result of a previous monad) the result owns its value: the input value is moved into it,
+or the stored result is copied into it.
+*/
+template <typename F>
+auto or_else_once(F&& f) {
+    using StoredType = typename detail::computed_once<std::decay_t<F>>::value_type;
+    using ValueType = typename std::conditional_t<is_optional_v<StoredType>, StoredType, std::optional<StoredType>>::value_type;
+
+    auto fallback = std::make_shared<detail::computed_once<std::decay_t<F>>>(std::forward<F>(f));
+    auto by_reference = or_else([fallback]() -> const auto& { return fallback->get(); });
+
+    return [fallback, by_reference](auto&& x) {
+        if constexpr (std::is_lvalue_reference_v<decltype(x)>) {
+            return by_reference(x);
+        } else {
+            if (x.has_value()) {
+                return std::optional<ValueType>{*std::move(x)};
+            }
+            return std::optional<ValueType>{fallback->get()};
+        }
+    };
+}
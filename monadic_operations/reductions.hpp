@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "monadic_operations.hpp"
+
+/*
+elements are resolved a block at a time into a dense buffer of values and a presence mask,
+which reducers then fold in reduce_lanes independent accumulators so the compiler can vectorize them.
+values of empty elements are value-initialized in the buffer.
+*/
+constexpr inline std::size_t reduce_block_size = 256;
+constexpr inline std::size_t reduce_lanes = 8;
+
+/*
+counts results that have value.
+*/
+struct count_reducer {
+    template <typename T>
+    std::size_t identity() const {
+        return 0;
+    }
+
+    template <typename T>
+    void add(std::size_t& acc, const T&) const {
+        ++acc;
+    }
+
+    template <typename T>
+    void add_block(std::size_t& acc, const T*, const unsigned char* present, std::size_t size) const {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            count += present[i];
+        }
+        acc += count;
+    }
+
+    std::size_t merge(std::size_t lhs, std::size_t rhs) const {
+        return lhs + rhs;
+    }
+};
+
+/*
+sums the values of results that have value. floating point sums are added in a different order than a sequential loop would.
+*/
+struct sum_reducer {
+    template <typename T>
+    T identity() const {
+        return T{};
+    }
+
+    template <typename T>
+    void add(T& acc, const T& value) const {
+        acc += value;
+    }
+
+    template <typename T>
+    void add_block(T& acc, const T* values, const unsigned char*, std::size_t size) const {
+        T lanes[reduce_lanes] = {};
+        std::size_t i = 0;
+        for (; i + reduce_lanes <= size; i += reduce_lanes) {
+            for (std::size_t lane = 0; lane < reduce_lanes; ++lane) {
+                lanes[lane] += values[i + lane];
+            }
+        }
+        for (; i < size; ++i) {
+            lanes[0] += values[i];
+        }
+        for (const auto& lane : lanes) {
+            acc += lane;
+        }
+    }
+
+    template <typename T>
+    T merge(const T& lhs, const T& rhs) const {
+        return lhs + rhs;
+    }
+};
+
+/*
+smallest (Min) or largest value of results that have value, nullopt if none has.
+*/
+template <bool Min>
+struct extremum_reducer {
+    template <typename T>
+    std::optional<T> identity() const {
+        return std::nullopt;
+    }
+
+    template <typename T>
+    void add(std::optional<T>& acc, const T& value) const {
+        if (!acc || better(value, *acc)) {
+            acc = value;
+        }
+    }
+
+    template <typename T>
+    void add_block(std::optional<T>& acc, const T* values, const unsigned char* present, std::size_t size) const {
+        if constexpr (std::is_arithmetic_v<T>) {
+            constexpr T sentinel = worst<T>();
+
+            T lanes[reduce_lanes];
+            std::fill(std::begin(lanes), std::end(lanes), sentinel);
+            unsigned char any = 0;
+
+            std::size_t i = 0;
+            for (; i + reduce_lanes <= size; i += reduce_lanes) {
+                for (std::size_t lane = 0; lane < reduce_lanes; ++lane) {
+                    const T value = values[i + lane];
+                    const T candidate = present[i + lane] ? value : sentinel;
+                    lanes[lane] = Min ? std::min(lanes[lane], candidate) : std::max(lanes[lane], candidate);
+                    any |= present[i + lane];
+                }
+            }
+            for (; i < size; ++i) {
+                const T value = present[i] ? values[i] : sentinel;
+                lanes[0] = Min ? std::min(lanes[0], value) : std::max(lanes[0], value);
+                any |= present[i];
+            }
+
+            if (any) {
+                for (const auto& lane : lanes) {
+                    add(acc, lane);
+                }
+            }
+        } else {
+            for (std::size_t i = 0; i < size; ++i) {
+                if (present[i]) {
+                    add(acc, values[i]);
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    std::optional<T> merge(std::optional<T> lhs, const std::optional<T>& rhs) const {
+        if (rhs) {
+            add(lhs, *rhs);
+        }
+        return lhs;
+    }
+
+private:
+    /*
+    value of T no present value can lose against, so empty elements never win their lane.
+    */
+    template <typename T>
+    static constexpr T worst() {
+        using limits = std::numeric_limits<T>;
+        if constexpr (limits::has_infinity) {
+            return Min ? limits::infinity() : -limits::infinity();
+        } else {
+            return Min ? limits::max() : limits::lowest();
+        }
+    }
+
+    template <typename T>
+    static bool better(const T& lhs, const T& rhs) {
+        if constexpr (Min) {
+            return lhs < rhs;
+        } else {
+            return rhs < lhs;
+        }
+    }
+};
+
+/*
+folds the values of results that have value with op, starting from init.
+op has to be associative and init its identity, since blocks and threads are folded separately and then merged with op.
+*/
+template <typename T, typename Op>
+struct fold_reducer {
+    T init;
+    Op op;
+
+    template <typename V>
+    T identity() const {
+        return init;
+    }
+
+    template <typename V>
+    void add(T& acc, const V& value) const {
+        acc = op(std::move(acc), value);
+    }
+
+    template <typename V>
+    void add_block(T& acc, const V* values, const unsigned char* present, std::size_t size) const {
+        for (std::size_t i = 0; i < size; ++i) {
+            if (present[i]) {
+                add(acc, values[i]);
+            }
+        }
+    }
+
+    T merge(T lhs, const T& rhs) const {
+        return op(std::move(lhs), rhs);
+    }
+};
+
+inline count_reducer count_present() {
+    return {};
+}
+
+inline sum_reducer sum_present() {
+    return {};
+}
+
+inline extremum_reducer<true> min_present() {
+    return {};
+}
+
+inline extremum_reducer<false> max_present() {
+    return {};
+}
+
+template <typename T, typename Op>
+auto fold_present(T&& init, Op&& op) {
+    return fold_reducer<std::decay_t<T>, std::decay_t<Op>>{std::forward<T>(init), std::forward<Op>(op)};
+}
+
+namespace detail {
+
+template <typename T>
+struct unwrap_reference {
+    using type = T;
+};
+
+template <typename T>
+struct unwrap_reference<std::reference_wrapper<T>> {
+    using type = T;
+};
+
+template <typename T, typename... Monads>
+decltype(auto) resolve_element(T&& maybe_value, Monads&... monads) {
+    if constexpr (sizeof...(Monads) == 0) {
+        return static_cast<T>(std::forward<T>(maybe_value));
+    } else {
+        return resolve(std::forward<T>(maybe_value), monads...);
+    }
+}
+
+template <typename InputIt, typename... Monads>
+using reduced_value_t = std::remove_cv_t<typename unwrap_reference<typename std::decay_t<
+    decltype(resolve_element(*std::declval<InputIt&>(), std::declval<Monads&>()...))>::value_type>::type>;
+
+template <typename Reducer, typename InputIt, typename... Monads>
+auto reduce_range(const Reducer& reducer, InputIt first, InputIt last, Monads&... monads) {
+    using value_type = reduced_value_t<InputIt, Monads...>;
+    auto acc = reducer.template identity<value_type>();
+
+    if constexpr (std::is_trivially_copyable_v<value_type> && std::is_default_constructible_v<value_type>) {
+        value_type values[reduce_block_size];
+        unsigned char present[reduce_block_size];
+
+        while (first != last) {
+            std::size_t size = 0;
+            for (; size < reduce_block_size && first != last; ++size, ++first) {
+                auto&& result = resolve_element(*first, monads...);
+                present[size] = result.has_value() ? 1 : 0;
+                values[size] = result.has_value() ? static_cast<const value_type&>(*result) : value_type{};
+            }
+            reducer.add_block(acc, values, present, size);
+        }
+    } else {
+        for (; first != last; ++first) {
+            auto&& result = resolve_element(*first, monads...);
+            if (result.has_value()) {
+                reducer.add(acc, static_cast<const value_type&>(*result));
+            }
+        }
+    }
+    return acc;
+}
+
+}
+
+/*
+resolves every optional in [first, last) through given monads and reduces the results with reducer (count_present, sum_present,
+min_present, max_present, fold_present) in the same pass. no intermediate results are stored.
+*/
+template <typename InputIt, typename Reducer, typename... Monads>
+auto resolve_reduce(InputIt first, InputIt last, const Reducer& reducer, Monads&&... monads) {
+    return detail::reduce_range(reducer, first, last, monads...);
+}
+
+/*
+same as resolve_reduce, with the range split into contiguous parts reduced on up to thread_count threads
+(hardware concurrency if 0), and the partial results merged pairwise in range order.
+monads are called from several threads at once, so they have to be thread-safe.
+*/
+template <typename RandomIt, typename Reducer, typename... Monads>
+auto resolve_reduce_parallel(RandomIt first, RandomIt last, std::size_t thread_count, const Reducer& reducer, Monads&&... monads) {
+    using acc_type = decltype(detail::reduce_range(reducer, first, first, monads...));
+
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const auto size = static_cast<std::size_t>(std::distance(first, last));
+    const std::size_t parts = std::max<std::size_t>(1, std::min(thread_count, size / reduce_block_size));
+
+    std::vector<std::optional<acc_type>> partials(parts);
+    std::vector<std::exception_ptr> errors(parts);
+    auto reduce_part = [&](std::size_t part) {
+        try {
+            const auto begin = first + static_cast<std::ptrdiff_t>(size * part / parts);
+            const auto end = first + static_cast<std::ptrdiff_t>(size * (part + 1) / parts);
+            partials[part].emplace(detail::reduce_range(reducer, begin, end, monads...));
+        } catch (...) {
+            errors[part] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(parts - 1);
+    for (std::size_t part = 1; part < parts; ++part) {
+        threads.emplace_back(reduce_part, part);
+    }
+    reduce_part(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    for (std::size_t step = 1; step < parts; step *= 2) {
+        for (std::size_t part = 0; part + step < parts; part += 2 * step) {
+            partials[part].emplace(reducer.merge(std::move(*partials[part]), *partials[part + step]));
+        }
+    }
+    return std::move(*partials[0]);
+}
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "monadic_operations.hpp"
+
+/*
+bounded lock-free queue for exactly one producer and one consumer thread. elements are handed over in batches.
+capacity is rounded up to a power of two. storage is allocated once, in the constructor.
+*/
+template <typename T>
+class spsc_ring {
+public:
+    explicit spsc_ring(std::size_t capacity) : slots_(round_up(capacity)), mask_{slots_.size() - 1} {}
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    std::size_t capacity() const noexcept {
+        return slots_.size();
+    }
+
+    /*
+    producer side. moves up to count elements from first into the queue, returns how many it moved.
+    */
+    template <typename It>
+    std::size_t try_push(It first, std::size_t count) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (capacity() - (tail - head_cache_) < count) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+        }
+        const std::size_t pushed = std::min(count, capacity() - (tail - head_cache_));
+
+        for (std::size_t i = 0; i < pushed; ++i, ++first) {
+            slots_[(tail + i) & mask_].emplace(std::move(*first));
+        }
+        tail_.store(tail + pushed, std::memory_order_release);
+        return pushed;
+    }
+
+    /*
+    consumer side. moves up to count elements out of the queue into out, returns how many it moved.
+    */
+    template <typename OutputIt>
+    std::size_t try_pop(OutputIt out, std::size_t count) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_cache_ - head < count) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+        }
+        const std::size_t popped = std::min(count, tail_cache_ - head);
+
+        for (std::size_t i = 0; i < popped; ++i, ++out) {
+            auto& slot = slots_[(head + i) & mask_];
+            *out = std::move(*slot);
+            slot.reset();
+        }
+        head_.store(head + popped, std::memory_order_release);
+        return popped;
+    }
+
+    /*
+    number of queued elements. exact only when called from the producer or the consumer thread.
+    */
+    std::size_t size() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    /*
+    called by the producer after its last push.
+    */
+    void close() noexcept {
+        closed_.store(true, std::memory_order_release);
+    }
+
+    bool closed() const noexcept {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+private:
+    static std::size_t round_up(std::size_t capacity) {
+        std::size_t result = 1;
+        while (result < capacity) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    std::vector<std::optional<T>> slots_;
+    std::size_t mask_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::size_t tail_cache_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::size_t head_cache_ = 0;
+    alignas(64) std::atomic<bool> closed_{false};
+};
+
+struct staged_options {
+    std::size_t queue_capacity = 1024;
+    std::size_t batch_size = 64;
+};
+
+/*
+what a stage did during resolve_staged. occupancy is the fill level of the stage's output queue, sampled after every batch it pushed.
+*/
+struct stage_stats {
+    std::size_t processed = 0;
+    std::size_t emitted = 0;
+    std::chrono::nanoseconds busy{0};
+    double mean_queue_occupancy = 0;
+    std::size_t max_queue_occupancy = 0;
+};
+
+template <typename OutputIt, std::size_t N>
+struct staged_result {
+    OutputIt out;
+    std::array<stage_stats, N> stages;
+};
+
+namespace detail {
+
+template <typename V, typename... Monads>
+struct staged_value_types {
+    using type = std::tuple<V>;
+};
+
+template <typename V, typename Monad, typename... Monads>
+struct staged_value_types<V, Monad, Monads...> {
+    using next_type = typename std::decay_t<std::invoke_result_t<Monad&, std::optional<V>&&>>::value_type;
+    using type = decltype(std::tuple_cat(std::declval<std::tuple<V>>(),
+                                         std::declval<typename staged_value_types<next_type, Monads...>::type>()));
+};
+
+/*
+monads that are known to turn an empty input into an empty result. anything else (or_else, user monads) may recover empties.
+*/
+template <typename Monad>
+constexpr inline bool propagates_empty_v = false;
+
+template <typename Monad, typename F>
+constexpr inline bool propagates_empty_v<by_value_monad<Monad, invoke_by_value_policy<F>>> = true;
+
+template <typename Monad, typename F>
+constexpr inline bool propagates_empty_v<by_value_monad<Monad, predicate_by_value_policy<F>>> = true;
+
+template <bool Adaptive, typename... Predicates>
+constexpr inline bool propagates_empty_v<filter_all_monad<Adaptive, Predicates...>> = true;
+
+template <typename Container>
+constexpr inline bool propagates_empty_v<lookup_monad<Container>> = true;
+
+template <typename F>
+constexpr inline bool propagates_empty_v<batched_and_then_monad<F>> = true;
+
+template <typename InputIt, typename... Monads>
+class staged_run {
+    static constexpr std::size_t size = sizeof...(Monads);
+
+    using input_type = std::decay_t<typename std::iterator_traits<InputIt>::reference>;
+    using value_types = typename staged_value_types<typename input_type::value_type, Monads...>::type;
+
+    template <std::size_t I>
+    using value_type = std::tuple_element_t<I, value_types>;
+
+    template <std::size_t I>
+    using element_type = std::optional<value_type<I>>;
+
+    /*
+    stage I drops its empty results only if every later monad would pass them on empty anyway.
+    */
+    template <std::size_t I, std::size_t... Later>
+    static constexpr bool drops_empty(std::index_sequence<Later...>) {
+        return (propagates_empty_v<std::decay_t<std::tuple_element_t<I + 1 + Later, std::tuple<Monads...>>>> && ...);
+    }
+
+    template <std::size_t I>
+    static constexpr bool drops_empty_v = drops_empty<I>(std::make_index_sequence<size - I - 1>{});
+
+    template <std::size_t... I>
+    static auto make_queues(std::index_sequence<I...>) -> std::tuple<std::unique_ptr<spsc_ring<element_type<I + 1>>>...>;
+
+    using queues_type = decltype(make_queues(std::make_index_sequence<size>{}));
+
+public:
+    using result_type = value_type<size>;
+
+    staged_run(const staged_options& options, Monads&... monads)
+        : options_{options.queue_capacity, std::max<std::size_t>(options.batch_size, 1)}, monads_{monads...},
+          resource_{detail::attached_memory_resource()} {
+        std::apply([this](auto&... queues) {
+            ((queues = std::make_unique<typename std::decay_t<decltype(queues)>::element_type>(options_.queue_capacity)), ...);
+        }, queues_);
+    }
+
+    template <typename OutputIt>
+    staged_result<OutputIt, size> run(InputIt first, InputIt last, OutputIt out) {
+        std::vector<std::thread> threads;
+        threads.reserve(size);
+        start_stages(threads, first, last, std::make_index_sequence<size>{});
+
+        try {
+            out = drain(out);
+        } catch (...) {
+            fail(std::current_exception());
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        return {out, stats_};
+    }
+
+private:
+    template <std::size_t... I>
+    void start_stages(std::vector<std::thread>& threads, InputIt first, InputIt last, std::index_sequence<I...>) {
+        (threads.emplace_back([this, first, last]() {
+            memory_resource_scope scope{resource_};
+            try {
+                if constexpr (I == 0) {
+                    run_first_stage(first, last);
+                } else {
+                    run_stage<I>();
+                }
+            } catch (...) {
+                fail(std::current_exception());
+            }
+            std::get<I>(queues_)->close();
+        }), ...);
+    }
+
+    void run_first_stage(InputIt first, InputIt last) {
+        std::vector<element_type<1>> batch;
+        batch.reserve(options_.batch_size);
+
+        for (; first != last && !aborted_.load(std::memory_order_relaxed); ++first) {
+            apply<0>(input_type(*first), batch);
+            if (batch.size() == options_.batch_size) {
+                push<0>(batch);
+            }
+        }
+        push<0>(batch);
+    }
+
+    template <std::size_t I>
+    void run_stage() {
+        std::vector<element_type<I>> inputs(options_.batch_size);
+        std::vector<element_type<I + 1>> batch;
+        batch.reserve(options_.batch_size);
+
+        while (std::size_t count = pop<I - 1>(inputs.begin())) {
+            for (std::size_t i = 0; i < count; ++i) {
+                apply<I>(std::move(inputs[i]), batch);
+            }
+            push<I>(batch);
+        }
+    }
+
+    template <std::size_t I, typename X>
+    void apply(X&& x, std::vector<element_type<I + 1>>& batch) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = std::get<I>(monads_)(std::forward<X>(x));
+        stats_[I].busy += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        ++stats_[I].processed;
+
+        if (result.has_value()) {
+            ++stats_[I].emitted;
+        } else if constexpr (drops_empty_v<I>) {
+            return;
+        }
+        batch.push_back(std::move(result));
+    }
+
+    /*
+    hands the whole batch over to the next stage, waiting for room in its queue.
+    */
+    template <std::size_t I>
+    void push(std::vector<element_type<I + 1>>& batch) {
+        if (batch.empty()) {
+            return;
+        }
+
+        auto& queue = *std::get<I>(queues_);
+        auto next = batch.begin();
+        for (std::size_t left = batch.size(); left != 0 && !aborted_.load(std::memory_order_relaxed);) {
+            const std::size_t pushed = queue.try_push(next, left);
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+            next += static_cast<std::ptrdiff_t>(pushed);
+            left -= pushed;
+        }
+        batch.clear();
+
+        const std::size_t occupancy = queue.size();
+        auto& stats = stats_[I];
+        stats.max_queue_occupancy = std::max(stats.max_queue_occupancy, occupancy);
+        stats.mean_queue_occupancy += (static_cast<double>(occupancy) - stats.mean_queue_occupancy) / static_cast<double>(++samples_[I]);
+    }
+
+    /*
+    waits for the next batch of stage I's output. returns 0 once stage I is done and its queue drained.
+    */
+    template <std::size_t I, typename OutputIt>
+    std::size_t pop(OutputIt out) {
+        auto& queue = *std::get<I>(queues_);
+        while (!aborted_.load(std::memory_order_relaxed)) {
+            if (std::size_t count = queue.try_pop(out, options_.batch_size)) {
+                return count;
+            }
+            if (queue.closed()) {
+                return queue.try_pop(out, options_.batch_size);
+            }
+            std::this_thread::yield();
+        }
+        return 0;
+    }
+
+    template <typename OutputIt>
+    OutputIt drain(OutputIt out) {
+        std::vector<element_type<size>> results(options_.batch_size);
+        while (std::size_t count = pop<size - 1>(results.begin())) {
+            for (std::size_t i = 0; i < count; ++i, ++out) {
+                *out = *std::move(results[i]);
+            }
+        }
+        return out;
+    }
+
+    void fail(std::exception_ptr error) {
+        if (!aborted_.exchange(true)) {
+            error_ = error;
+        }
+    }
+
+    staged_options options_;
+    std::tuple<Monads&...> monads_;
+    queues_type queues_;
+    std::array<stage_stats, size> stats_{};
+    std::array<std::size_t, size> samples_{};
+    std::pmr::memory_resource* resource_;
+    std::atomic<bool> aborted_{false};
+    std::exception_ptr error_;
+};
+
+}
+
+/*
+resolves every optional in [first, last) through given monads like resolve_all, with every monad running on its own thread.
+monads are connected by spsc_ring queues and hand elements over in batches of options.batch_size.
+values of engaged final results are written to out, in input order. they are the same values resolve_all gives.
+elements that come out of a monad empty are dropped right there, unless a later monad may recover them
+(anything but transform, and_then, filter, filter_all, lookup and batched_and_then), in which case they are passed on.
+every monad is only ever called from its own thread, so it needs no synchronization of its own.
+the memory resource attached on the calling thread (see memory_resource_scope) is attached on every stage thread too,
+so stages allocate from it concurrently: it has to be thread-safe (e.g. std::pmr::synchronized_pool_resource).
+std::pmr::monotonic_buffer_resource and unsynchronized_pool_resource are not, and must not be attached around this call.
+exceptions thrown by a monad stop the pipeline and are rethrown from here.
+returns out past the last written value, and stats of every monad.
+*/
+template <typename InputIt, typename OutputIt, typename... Monads>
+auto resolve_staged(InputIt first, InputIt last, OutputIt out, const staged_options& options, Monads&&... monads) {
+    static_assert(sizeof...(Monads) > 0, "resolve_staged needs at least one monad");
+    detail::staged_run<InputIt, std::remove_reference_t<Monads>...> run{options, monads...};
+    return run.run(first, last, out);
+}
+
+template <typename InputIt, typename OutputIt, typename... Monads,
+          std::enable_if_t<!(std::is_same_v<std::decay_t<Monads>, staged_options> || ...), int> = 0>
+auto resolve_staged(InputIt first, InputIt last, OutputIt out, Monads&&... monads) {
+    return resolve_staged(first, last, out, staged_options{}, std::forward<Monads>(monads)...);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <monadic_operations.hpp>
+#include "track_copies.hpp"
+
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+struct BatchLookup {
+    const std::unordered_map<int, std::string>* table;
+    std::vector<std::vector<int>>* batches;
+
+    std::vector<std::optional<std::string>> operator()(const std::vector<int>& keys) const {
+        batches->push_back(keys);
+        std::vector<std::optional<std::string>> results;
+        for (auto key : keys) {
+            auto it = table->find(key);
+            results.push_back(it != table->end() ? std::make_optional(it->second) : std::nullopt);
+        }
+        return results;
+    }
+};
+
+}
+
+TEST(MonadTests, ResolveAllAppliesMonadsToEveryElement) {
+    const std::vector<std::optional<int>> inputs{1, std::nullopt, 3, 4};
+    std::vector<std::optional<int>> results;
+
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results),
+                transform([](int x) { return x * 2; }),
+                filter([](int x) { return x > 2; }),
+                or_else([]() { return 0; }));
+
+    EXPECT_EQ((std::vector<std::optional<int>>{0, 0, 6, 8}), results);
+}
+
+TEST(MonadTests, ResolveAllReferenceResultsTest) {
+    const std::vector<std::optional<std::pair<int, std::string>>> inputs{
+        std::make_pair(1, std::string(64, 'a')), std::nullopt, std::make_pair(2, std::string(64, 'b'))};
+    std::vector<std::optional<std::reference_wrapper<const std::string>>> results;
+
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results),
+                transform([](const std::pair<int, std::string>& p) -> const std::pair<int, std::string>& { return p; }),
+                transform([](const std::pair<int, std::string>& p) -> const std::string& { return p.second; }));
+
+    ASSERT_EQ(3u, results.size());
+    EXPECT_EQ(&inputs[0]->second, &results[0]->get());
+    EXPECT_FALSE(results[1].has_value());
+    EXPECT_EQ(std::string(64, 'b'), results[2]->get());
+}
+
+TEST(MonadTests, BatchedAndThenOnSingleOptional) {
+    const std::unordered_map<int, std::string> table{{1, "one"}, {2, "two"}};
+    std::vector<std::vector<int>> batches;
+
+    EXPECT_EQ("two", resolve(std::make_optional<int>(2), batched_and_then(BatchLookup{&table, &batches}, 8)).value());
+    EXPECT_EQ(std::nullopt, resolve(std::make_optional<int>(3), batched_and_then(BatchLookup{&table, &batches}, 8)));
+    EXPECT_EQ(std::nullopt, resolve(std::optional<int>{}, batched_and_then(BatchLookup{&table, &batches}, 8)));
+    EXPECT_EQ(2u, batches.size());
+}
+
+TEST(MonadTests, BatchedAndThenBatchesEngagedInputsInOrder) {
+    const std::unordered_map<int, std::string> table{{1, "one"}, {2, "two"}, {3, "three"}, {5, "five"}};
+    std::vector<std::vector<int>> batches;
+    const std::vector<std::optional<int>> inputs{1, std::nullopt, 2, 3, std::nullopt, 4, 5};
+
+    std::vector<std::optional<std::string>> results;
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results),
+                batched_and_then(BatchLookup{&table, &batches}, 2));
+
+    EXPECT_EQ((std::vector<std::optional<std::string>>{"one", std::nullopt, "two", "three", std::nullopt, std::nullopt, "five"}), results);
+    EXPECT_EQ((std::vector<std::vector<int>>{{1, 2}, {3, 4}, {5}}), batches);
+}
+
+TEST(MonadTests, BatchedAndThenSkipsAllEmptyInputs) {
+    const std::unordered_map<int, std::string> table{{1, "one"}};
+    std::vector<std::vector<int>> batches;
+    const std::vector<std::optional<int>> inputs{std::nullopt, std::nullopt};
+
+    std::vector<std::optional<std::string>> results;
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results),
+                batched_and_then(BatchLookup{&table, &batches}, 4));
+
+    EXPECT_EQ((std::vector<std::optional<std::string>>{std::nullopt, std::nullopt}), results);
+    EXPECT_TRUE(batches.empty());
+}
+
+TEST(MonadTests, BatchedAndThenCombinedWithOtherMonads) {
+    const std::unordered_map<int, std::string> table{{2, "two"}, {4, "four"}};
+    std::vector<std::vector<int>> batches;
+    const std::vector<std::optional<int>> inputs{1, 2, 3};
+
+    std::vector<std::optional<std::size_t>> results;
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results),
+                transform([](int x) { return x + 1; }),
+                batched_and_then(BatchLookup{&table, &batches}, 16),
+                transform([](const std::string& s) { return s.size(); }));
+
+    EXPECT_EQ((std::vector<std::optional<std::size_t>>{3, std::nullopt, 4}), results);
+    EXPECT_EQ(1u, batches.size());
+}
+
+TEST(MonadTests, NoCopyOnBatchedAndThenTest) {
+    const std::vector<std::optional<int>> inputs{1, 2};
+    std::vector<std::optional<TrackCopies>> results;
+
+    TrackCopies::reset_counts();
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results),
+                batched_and_then([](const std::vector<int>& keys) {
+                    std::vector<std::optional<TrackCopies>> values;
+                    values.reserve(keys.size());
+                    for (auto key : keys) {
+                        values.emplace_back(key);
+                    }
+                    return values;
+                }, 2));
+
+    ASSERT_EQ(2u, results.size());
+    EXPECT_EQ(2, results[1].value().value);
+    EXPECT_EQ(TrackCopies::copy_count, 0);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <monadic_operations.hpp>
+#include "track_copies.hpp"
+
+#include <string>
+
+namespace {
+
+template <typename Monad, typename X>
+constexpr bool takes_by_value(const Monad&) {
+    return Monad::template takes_by_value<X>();
+}
+
+}
+
+TEST(MonadTests, SmallTriviallyCopyableOptionalsPassedByValue) {
+    auto twice = transform([](int x) { return x * 2; });
+    static_assert(takes_by_value<decltype(twice), std::optional<int>>(twice));
+    static_assert(takes_by_value<decltype(twice), std::optional<double>>(twice));
+    static_assert(!takes_by_value<decltype(twice), std::optional<TrackCopies>>(twice));
+    static_assert(!takes_by_value<decltype(twice), std::optional<std::string>>(twice));
+
+    auto positive = filter([](double x) { return x > 0; });
+    static_assert(takes_by_value<decltype(positive), std::optional<double>>(positive));
+
+    auto half = and_then([](int x) { return x % 2 == 0 ? std::make_optional(x / 2) : std::nullopt; });
+    static_assert(takes_by_value<decltype(half), std::optional<int>>(half));
+
+    auto zero = or_else([]() { return 0; });
+    static_assert(takes_by_value<decltype(zero), std::optional<int>>(zero));
+
+    EXPECT_EQ(3.0, resolve(std::make_optional<int>(6), half, twice, or_else([]() { return 0; }), transform([](int x) { return x / 2.0; }), positive).value());
+}
+
+TEST(MonadTests, ReferenceSemanticsKeepReferencePath) {
+    auto increment = transform([](int& x) { return ++x; });
+    static_assert(!takes_by_value<decltype(increment), std::optional<int>>(increment));
+
+    auto maybe_five = std::make_optional<int>(5);
+    EXPECT_EQ(6, resolve(maybe_five, increment).value());
+    EXPECT_EQ(6, maybe_five.value());
+
+    auto same = transform([](auto&& x) -> auto& { return x; });
+    static_assert(!takes_by_value<decltype(same), std::optional<int>>(same));
+    auto ref_to_five = resolve(maybe_five, same);
+    ref_to_five.value().get() = 7;
+    EXPECT_EQ(7, maybe_five.value());
+
+    auto fallback = or_else([&maybe_five]() -> auto& { return maybe_five; });
+    static_assert(!takes_by_value<decltype(fallback), std::optional<int>>(fallback));
+
+    auto mutating_predicate = filter([](int& x) { return ++x > 0; });
+    static_assert(!takes_by_value<decltype(mutating_predicate), std::optional<int>>(mutating_predicate));
+    resolve(maybe_five, mutating_predicate);
+    EXPECT_EQ(8, maybe_five.value());
+}
+
+TEST(MonadTests, ByValueFromConstLValue) {
+    const auto maybe_four = std::make_optional<int>(4);
+    EXPECT_EQ(8, resolve(maybe_four, transform([](int x) { return x * 2; })).value());
+    EXPECT_EQ(4, resolve(maybe_four, filter([](int x) { return x > 2; })).value());
+    EXPECT_EQ(4, resolve(maybe_four, or_else([]() { return 0; })).value());
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <monadic_operations.hpp>
+#include "track_copies.hpp"
+
+#include <string>
+
+namespace {
+
+bool slow_always_true(int x) {
+    volatile int sink = x;
+    for (int i = 0; i < 2000; ++i) {
+        sink = sink + i;
+    }
+    return sink != x - 1;
+}
+
+}
+
+TEST(MonadTests, SimpleFilterAllTest) {
+    auto positive_even = filter_all([](int x) { return x > 0; }, [](int x) { return x % 2 == 0; });
+
+    EXPECT_EQ(4, resolve(std::make_optional<int>(4), positive_even).value());
+    EXPECT_EQ(std::nullopt, resolve(std::make_optional<int>(3), positive_even));
+    EXPECT_EQ(std::nullopt, resolve(std::make_optional<int>(-4), positive_even));
+    EXPECT_EQ(std::nullopt, resolve(std::optional<int>{}, positive_even));
+}
+
+TEST(MonadTests, FilterAllStringTest) {
+    auto result = resolve(std::make_optional<std::string>("hello"),
+                          filter_all([](const auto& s) { return s.size() == 5; },
+                                     [](const auto& s) { return s.front() == 'h'; }));
+    EXPECT_EQ("hello", result.value());
+}
+
+TEST(MonadTests, FilterAllMatchesFilterChainTest) {
+    auto all = filter_all([](int x) { return x % 3 != 0; },
+                          [](int x) { return x % 5 != 0; },
+                          [](int x) { return x % 7 != 0; });
+
+    for (int i = 0; i < 20000; ++i) {
+        auto input = i % 11 == 0 ? std::optional<int>{} : std::make_optional(i);
+        ASSERT_EQ(resolve(input,
+                          filter([](int x) { return x % 3 != 0; }),
+                          filter([](int x) { return x % 5 != 0; }),
+                          filter([](int x) { return x % 7 != 0; })),
+                  resolve(input, all)) << i;
+    }
+}
+
+TEST(MonadTests, FilterAllMovesCheapSelectivePredicateFirstTest) {
+    int expensive_calls = 0;
+    auto all = filter_all([&expensive_calls](int x) { ++expensive_calls; return slow_always_true(x); },
+                          [](int x) { return x % 100 == 0; });
+
+    EXPECT_EQ((std::array<std::size_t, 2>{0, 1}), all.evaluation_order());
+    for (int i = 0; i < 3 * static_cast<int>(filter_all_reorder_interval); ++i) {
+        resolve(std::make_optional(i), all);
+    }
+    EXPECT_EQ((std::array<std::size_t, 2>{1, 0}), all.evaluation_order());
+
+    expensive_calls = 0;
+    for (int i = 1; i < 100; ++i) {
+        resolve(std::make_optional(i), all);
+    }
+    EXPECT_LE(expensive_calls, 2);
+}
+
+TEST(MonadTests, FilterAllSamplingStopsAtFirstRejectionTest) {
+    int guarded_calls = 0;
+    auto filtered = filter_all([](int x) { return x != 0; },
+                               [&guarded_calls](int x) { ++guarded_calls; return 100 / x > 1; });
+
+    std::optional<int> zero = 0;
+    for (std::size_t i = 0; i < 4 * filter_all_sample_interval; ++i) {
+        EXPECT_FALSE(resolve(zero, filtered).has_value());
+    }
+    EXPECT_EQ(0, guarded_calls);
+}
+
+TEST(MonadTests, FilterAllOrderedTest) {
+    std::vector<int> calls;
+    auto ordered = filter_all_ordered({2, 0, 1},
+                                      [&calls](int) { calls.push_back(0); return true; },
+                                      [&calls](int) { calls.push_back(1); return true; },
+                                      [&calls](int) { calls.push_back(2); return false; });
+
+    EXPECT_EQ(std::nullopt, resolve(std::make_optional<int>(1), ordered));
+    EXPECT_EQ((std::vector<int>{2}), calls);
+    EXPECT_EQ((std::array<std::size_t, 3>{2, 0, 1}), ordered.evaluation_order());
+}
+
+TEST(MonadTests, NoCopyOnFilterAllTest) {
+    TrackCopies::reset_counts();
+
+    auto result = resolve(std::make_optional<TrackCopies>(5),
+                          filter_all([](const TrackCopies& t) { return t.value > 1; },
+                                     [](const TrackCopies& t) { return t.value < 10; }));
+
+    EXPECT_TRUE(result.has_value());
+    EXPECT_EQ(TrackCopies::copy_count, 0);
+    EXPECT_EQ(TrackCopies::move_count, 1);
+}
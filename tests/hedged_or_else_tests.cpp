@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <hedged_or_else.hpp>
+
+#include <chrono>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::future<std::optional<int>> failing_lookup(std::chrono::milliseconds latency) {
+    return std::async(std::launch::async, [latency]() -> std::optional<int> {
+        std::this_thread::sleep_for(latency);
+        throw std::runtime_error("lookup failed");
+    });
+}
+
+std::future<std::optional<int>> slow_lookup(std::optional<int> result, std::chrono::milliseconds latency) {
+    return std::async(std::launch::async, [result, latency]() {
+        std::this_thread::sleep_for(latency);
+        return result;
+    });
+}
+
+}
+
+TEST(MonadTests, HedgedOrElseFastPrimaryTest) {
+    int fallback_calls = 0;
+    auto hedged = hedged_or_else([&fallback_calls]() { ++fallback_calls; return 2; }, 500ms);
+
+    EXPECT_EQ(1, resolve(slow_lookup(1, 0ms), hedged).value());
+    EXPECT_EQ(0, fallback_calls);
+    EXPECT_EQ(1u, hedged.stats().calls);
+    EXPECT_EQ(0u, hedged.stats().hedges);
+    EXPECT_EQ(1u, hedged.stats().primary_wins);
+}
+
+TEST(MonadTests, HedgedOrElseFastEmptyPrimaryTest) {
+    auto hedged = hedged_or_else([]() { return std::make_optional<int>(2); }, 500ms);
+
+    EXPECT_EQ(4, resolve(slow_lookup(std::nullopt, 0ms), hedged, transform([](int x) { return x * 2; })).value());
+    EXPECT_EQ(0u, hedged.stats().hedges);
+    EXPECT_EQ(1u, hedged.stats().fallback_wins);
+}
+
+TEST(MonadTests, HedgedOrElseSlowPrimaryTest) {
+    auto hedged = hedged_or_else([]() { return 2; }, 5ms);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(2, resolve(slow_lookup(1, 1000ms), hedged).value());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1000ms);
+
+    EXPECT_EQ(1u, hedged.stats().hedges);
+    EXPECT_EQ(1u, hedged.stats().fallback_wins);
+    EXPECT_EQ(1u, hedged.stats().cancellations);
+}
+
+TEST(MonadTests, HedgedOrElsePrimaryWinsRaceTest) {
+    auto fallback_cancelled = std::make_shared<std::promise<void>>();
+    auto cancelled = fallback_cancelled->get_future();
+
+    auto hedged = hedged_or_else([fallback_cancelled](const hedge_cancellation& cancellation) -> std::optional<int> {
+        while (!cancellation.requested()) {
+            std::this_thread::sleep_for(1ms);
+        }
+        fallback_cancelled->set_value();
+        return 2;
+    }, 5ms);
+
+    EXPECT_EQ(1, resolve(slow_lookup(1, 50ms), hedged).value());
+    EXPECT_EQ(std::future_status::ready, cancelled.wait_for(1s));
+
+    EXPECT_EQ(1u, hedged.stats().hedges);
+    EXPECT_EQ(1u, hedged.stats().primary_wins);
+    EXPECT_EQ(1u, hedged.stats().cancellations);
+}
+
+TEST(MonadTests, HedgedOrElseEmptyFallbackWaitsForPrimaryTest) {
+    auto hedged = hedged_or_else([]() { return std::optional<int>{}; }, 5ms);
+
+    EXPECT_EQ(1, resolve(slow_lookup(1, 50ms), hedged).value());
+    EXPECT_EQ(1u, hedged.stats().primary_wins);
+    EXPECT_EQ(0u, hedged.stats().cancellations);
+}
+
+TEST(MonadTests, HedgedOrElseBothEmptyTest) {
+    auto hedged = hedged_or_else([]() { return std::optional<int>{}; }, 5ms);
+
+    EXPECT_EQ(std::nullopt, resolve(slow_lookup(std::nullopt, 50ms), hedged));
+    EXPECT_EQ(1u, hedged.stats().hedges);
+    EXPECT_EQ(0u, hedged.stats().primary_wins);
+    EXPECT_EQ(0u, hedged.stats().fallback_wins);
+}
+
+TEST(MonadTests, HedgedOrElseCustomExecutorTest) {
+    auto submitted = std::make_shared<std::atomic<int>>(0);
+    auto executor = [submitted](std::function<void()> task) {
+        ++*submitted;
+        std::thread(std::move(task)).detach();
+    };
+
+    auto hedged = hedged_or_else([]() { return 2; }, 5ms, executor);
+    EXPECT_EQ(2, resolve(slow_lookup(1, 1000ms), hedged).value());
+    EXPECT_EQ(2, submitted->load());
+
+    EXPECT_EQ(1, resolve(slow_lookup(1, 0ms), hedged_or_else([]() { return 2; }, 500ms, executor)).value());
+    EXPECT_EQ(2, submitted->load());
+}
+
+TEST(MonadTests, HedgedOrElseThrowingPrimaryTest) {
+    auto empty_fallback = hedged_or_else([]() { return std::optional<int>{}; }, 5ms);
+    EXPECT_THROW(resolve(failing_lookup(50ms), empty_fallback), std::runtime_error);
+
+    auto fallback = hedged_or_else([]() { return 2; }, 5ms);
+    EXPECT_EQ(2, resolve(failing_lookup(50ms), fallback).value());
+    EXPECT_EQ(1u, fallback.stats().fallback_wins);
+}
+
+TEST(MonadTests, HedgedOrElseThrowingFallbackTest) {
+    auto hedged = hedged_or_else([]() -> int { throw std::runtime_error("fallback failed"); }, 5ms);
+
+    EXPECT_EQ(1, resolve(slow_lookup(1, 50ms), hedged).value());
+    EXPECT_EQ(1u, hedged.stats().primary_wins);
+    EXPECT_THROW(resolve(slow_lookup(std::nullopt, 50ms), hedged), std::runtime_error);
+}
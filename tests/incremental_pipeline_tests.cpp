@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <incremental_pipeline.hpp>
+
+#include <stdexcept>
+#include <string>
+
+TEST(MonadTests, IncrementalPipelineMatchesResolve) {
+    auto pipeline = make_incremental_pipeline<std::optional<int>>(
+        filter([](int x) { return x >= 0; }),
+        transform([](int x) { return std::to_string(x); }),
+        or_else([]() { return std::string{"negative"}; }));
+
+    for (auto input : {std::make_optional(4), std::make_optional(-4), std::optional<int>{}, std::make_optional(4)}) {
+        EXPECT_EQ(resolve(input,
+                          filter([](int x) { return x >= 0; }),
+                          transform([](int x) { return std::to_string(x); }),
+                          or_else([]() { return std::string{"negative"}; })),
+                  pipeline.update(input));
+    }
+}
+
+TEST(MonadTests, IncrementalPipelineSkipsUnchangedInput) {
+    int transform_calls = 0;
+    auto pipeline = make_incremental_pipeline<std::optional<int>>(
+        transform([&transform_calls](int x) { ++transform_calls; return x * 2; }),
+        transform([](int x) { return x + 1; }));
+
+    EXPECT_EQ(11, pipeline.update(5).value());
+    EXPECT_EQ(2u, pipeline.last_recomputed());
+
+    EXPECT_EQ(11, pipeline.update(5).value());
+    EXPECT_EQ(0u, pipeline.last_recomputed());
+    EXPECT_EQ(1, transform_calls);
+
+    EXPECT_EQ(13, pipeline.update(6).value());
+    EXPECT_EQ(2u, pipeline.last_recomputed());
+    EXPECT_EQ(2, transform_calls);
+}
+
+TEST(MonadTests, IncrementalPipelineStopsAtUnchangedStage) {
+    int expensive_calls = 0;
+    auto pipeline = make_incremental_pipeline<std::optional<int>>(
+        transform([](int x) { return x / 10; }),
+        transform([&expensive_calls](int x) { ++expensive_calls; return x * 100; }),
+        transform([](int x) { return x + 1; }));
+
+    EXPECT_EQ(101, pipeline.update(12).value());
+    EXPECT_EQ(3u, pipeline.last_recomputed());
+
+    EXPECT_EQ(101, pipeline.update(17).value());
+    EXPECT_EQ(1u, pipeline.last_recomputed());
+    EXPECT_EQ(1, expensive_calls);
+
+    EXPECT_EQ(201, pipeline.update(23).value());
+    EXPECT_EQ(3u, pipeline.last_recomputed());
+    EXPECT_EQ(2, expensive_calls);
+}
+
+TEST(MonadTests, IncrementalPipelineVersionedUpdate) {
+    int calls = 0;
+    auto pipeline = make_incremental_pipeline<std::optional<int>>(
+        transform([&calls](int x) { ++calls; return x * 2; }));
+
+    EXPECT_EQ(10, pipeline.update(5, 1).value());
+    EXPECT_EQ(10, pipeline.update(6, 1).value());
+    EXPECT_EQ(0u, pipeline.last_recomputed());
+
+    EXPECT_EQ(12, pipeline.update(6, 2).value());
+    EXPECT_EQ(1u, pipeline.last_recomputed());
+
+    EXPECT_EQ(12, pipeline.update(6, 3).value());
+    EXPECT_EQ(0u, pipeline.last_recomputed());
+    EXPECT_EQ(2, calls);
+}
+
+TEST(MonadTests, IncrementalPipelineEmptyInput) {
+    auto pipeline = make_incremental_pipeline<std::optional<int>>(
+        transform([](int x) { return x * 2; }),
+        or_else([]() { return -1; }));
+
+    EXPECT_EQ(-1, pipeline.update(std::nullopt).value());
+    EXPECT_EQ(-1, pipeline.update(std::nullopt).value());
+    EXPECT_EQ(0u, pipeline.last_recomputed());
+    EXPECT_EQ(4, pipeline.update(2).value());
+}
+
+TEST(MonadTests, IncrementalPipelineRecomputesAfterThrowingStage) {
+    bool fail = false;
+    auto pipeline = make_incremental_pipeline<std::optional<int>>(
+        transform([](int x) { return x * 2; }),
+        transform([&fail](int x) {
+            if (fail) {
+                throw std::runtime_error("stage failed");
+            }
+            return x + 1;
+        }));
+
+    EXPECT_EQ(3, pipeline.update(1, 1).value());
+
+    fail = true;
+    EXPECT_THROW(pipeline.update(5, 2), std::runtime_error);
+    fail = false;
+
+    EXPECT_EQ(11, pipeline.update(5, 2).value());
+    EXPECT_EQ(2u, pipeline.last_recomputed());
+
+    fail = true;
+    EXPECT_THROW(pipeline.update(6), std::runtime_error);
+    fail = false;
+
+    EXPECT_EQ(11, pipeline.update(5).value());
+    EXPECT_EQ(2u, pipeline.last_recomputed());
+}
+
+TEST(MonadTests, IncrementalPipelineReferenceResults) {
+    auto pipeline = make_incremental_pipeline<std::optional<int>>(
+        transform([](int x) { return std::make_pair(x, x * 10); }),
+        transform([](const std::pair<int, int>& p) -> const int& { return p.second; }),
+        transform([](int x) { return x + 1; }));
+
+    EXPECT_EQ(11, pipeline.update(1).value());
+    EXPECT_EQ(21, pipeline.update(2).value());
+    EXPECT_EQ(3u, pipeline.last_recomputed());
+
+    auto first = make_incremental_pipeline<std::optional<std::pair<int, int>>>(
+        transform([](const std::pair<int, int>& p) -> const int& { return p.first; }),
+        transform([](int x) { return x * 2; }));
+
+    EXPECT_EQ(2, first.update(std::make_pair(1, 0)).value());
+    EXPECT_EQ(4, first.update(std::make_pair(2, 0)).value());
+}
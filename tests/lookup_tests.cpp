@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <monadic_operations.hpp>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+TEST(MonadTests, LookupInUnorderedMapTest) {
+    std::unordered_map<int, std::string> table{{1, "one"}, {2, "two"}};
+
+    auto result = resolve(std::make_optional<int>(2), lookup(table));
+    EXPECT_EQ("two", result.value().get());
+    EXPECT_EQ(std::nullopt, resolve(std::make_optional<int>(3), lookup(table)));
+    EXPECT_EQ(std::nullopt, resolve(std::optional<int>{}, lookup(table)));
+
+    result.value().get() = "deux";
+    EXPECT_EQ("deux", table.at(2));
+}
+
+TEST(MonadTests, LookupInConstMapTest) {
+    const std::map<std::string, int> table{{"one", 1}, {"two", 2}};
+
+    auto result = resolve(std::make_optional<std::string>("one"), lookup(table), transform([](int x) { return x * 10; }));
+    EXPECT_EQ(10, result.value());
+    EXPECT_EQ(std::nullopt, resolve(std::make_optional<std::string>("three"), lookup(table)));
+}
+
+TEST(MonadTests, LookupInSortedVectorTest) {
+    const std::vector<std::pair<int, char>> table{{1, 'a'}, {3, 'c'}, {5, 'e'}};
+
+    EXPECT_EQ('c', resolve(std::make_optional<int>(3), lookup(table)).value().get());
+    EXPECT_EQ(std::nullopt, resolve(std::make_optional<int>(4), lookup(table)));
+    EXPECT_EQ(std::nullopt, resolve(std::make_optional<int>(6), lookup(table)));
+}
+
+TEST(MonadTests, LookupOverRangeInUnorderedMapTest) {
+    std::unordered_map<int, int> table;
+    for (int i = 0; i < 1000; i += 2) {
+        table[i] = i * i;
+    }
+
+    std::vector<std::optional<int>> inputs;
+    for (int i = -5; i < 1005; ++i) {
+        inputs.push_back(i % 7 == 0 ? std::nullopt : std::make_optional(i));
+    }
+
+    std::vector<std::optional<int>> results;
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results),
+                lookup(table), transform([](int x) { return x; }));
+
+    ASSERT_EQ(inputs.size(), results.size());
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        EXPECT_EQ(resolve(inputs[i], lookup(table), transform([](int x) { return x; })), results[i]);
+    }
+}
+
+TEST(MonadTests, LookupOverRangeInSortedVectorTest) {
+    std::vector<std::pair<int, int>> table;
+    for (int i = 0; i < 1000; i += 3) {
+        table.emplace_back(i, -i);
+    }
+
+    std::vector<std::optional<int>> inputs;
+    for (int i = -5; i < 1005; ++i) {
+        inputs.push_back(i % 11 == 0 ? std::nullopt : std::make_optional(i));
+    }
+
+    std::vector<std::optional<std::reference_wrapper<int>>> results;
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results), lookup(table));
+
+    ASSERT_EQ(inputs.size(), results.size());
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        const bool found = inputs[i].has_value() && *inputs[i] >= 0 && *inputs[i] < 1000 && *inputs[i] % 3 == 0;
+        ASSERT_EQ(found, results[i].has_value()) << i;
+        if (found) {
+            EXPECT_EQ(-*inputs[i], results[i].value().get());
+            EXPECT_EQ(&table[*inputs[i] / 3].second, &results[i].value().get());
+        }
+    }
+}
+
+TEST(MonadTests, LookupOverRangeInEmptyContainerTest) {
+    std::vector<std::pair<int, int>> table;
+    const std::vector<std::optional<int>> inputs{1, std::nullopt};
+
+    std::vector<std::optional<std::reference_wrapper<int>>> results;
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results), lookup(table));
+
+    EXPECT_EQ(2u, results.size());
+    EXPECT_FALSE(results[0].has_value());
+    EXPECT_FALSE(results[1].has_value());
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <mapped_file.hpp>
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::optional<int> to_int(std::string_view sv) {
+    int r{};
+    auto [ptr, ec]{std::from_chars(sv.data(), sv.data() + sv.size(), r)};
+    if (ec == std::errc()) {
+        return r;
+    }
+    return std::nullopt;
+}
+
+struct TempFile {
+    std::string path;
+
+    TempFile(const char* name, const std::string& contents) : path{std::string{::testing::TempDir()} + name} {
+        std::ofstream{path, std::ios::binary} << contents;
+    }
+
+    ~TempFile() {
+        std::remove(path.c_str());
+    }
+};
+
+}
+
+TEST(MonadTests, ForEachRecordSplitsWithoutCopyTest) {
+    const std::string_view data = "4\none\n\n16\n";
+    std::vector<std::string_view> records;
+    for_each_record(data, '\n', [&records](std::string_view record) { records.push_back(record); });
+
+    ASSERT_EQ(4u, records.size());
+    EXPECT_EQ("4", records[0]);
+    EXPECT_EQ("one", records[1]);
+    EXPECT_EQ("", records[2]);
+    EXPECT_EQ("16", records[3]);
+    EXPECT_EQ(data.data(), records[0].data());
+    EXPECT_EQ(data.data() + 7, records[3].data());
+}
+
+TEST(MonadTests, ForEachRecordCustomDelimiterTest) {
+    std::vector<std::string_view> records;
+    for_each_record(std::string_view{"a,b,c"}, ',', [&records](std::string_view record) { records.push_back(record); });
+
+    EXPECT_EQ((std::vector<std::string_view>{"a", "b", "c"}), records);
+}
+
+TEST(MonadTests, ResolveRecordsFromMappedFileTest) {
+    TempFile file{"mapped_file_resolve_records.txt", "4\none\n-4\n9\n16"};
+    mapped_file mapped{file.path.c_str()};
+
+    std::vector<std::optional<int>> results;
+    resolve_records(mapped, '\n', [&results](auto&& result) { results.push_back(result); },
+                    and_then(to_int),
+                    filter([](auto i) { return i >= 0; }),
+                    transform([](auto i) { return i * 2; }));
+
+    EXPECT_EQ((std::vector<std::optional<int>>{8, std::nullopt, std::nullopt, 18, 32}), results);
+}
+
+TEST(MonadTests, ResolveRecordsKeepsViewsIntoMappingTest) {
+    TempFile file{"mapped_file_views.txt", "alpha;beta;gamma;"};
+    mapped_file mapped{file.path.c_str()};
+
+    std::vector<std::string_view> results;
+    resolve_records(mapped, ';', [&results](auto&& result) { results.push_back(result.value()); },
+                    filter([](auto sv) { return !sv.empty(); }));
+
+    ASSERT_EQ(3u, results.size());
+    EXPECT_EQ("gamma", results[2]);
+    EXPECT_EQ(mapped.view().data() + 11, results[2].data());
+}
+
+TEST(MonadTests, MappedEmptyFileTest) {
+    TempFile file{"mapped_file_empty.txt", ""};
+    mapped_file mapped{file.path.c_str()};
+
+    EXPECT_EQ(0u, mapped.size());
+    int calls = 0;
+    resolve_records(mapped, '\n', [&calls](auto&&) { ++calls; }, transform([](auto sv) { return sv.size(); }));
+    EXPECT_EQ(0, calls);
+}
+
+TEST(MonadTests, MappedMissingFileThrowsTest) {
+    EXPECT_THROW(mapped_file{"/nonexistent/mapped_file_test.txt"}, std::system_error);
+}
+
+TEST(MonadTests, MappedFileCreateWritesThroughMappingTest) {
+    static_assert(std::is_same_v<const char*, decltype(std::declval<const mapped_file&>().data())>);
+
+    TempFile file{"mapped_file_create.txt", ""};
+    {
+        auto created = mapped_file::create(file.path.c_str(), 5);
+        std::memcpy(created.writable_data(), "12345", 5);
+    }
+
+    mapped_file mapped{file.path.c_str()};
+    EXPECT_EQ("12345", mapped.view());
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <monadic_operations.hpp>
+#include "track_copies.hpp"
+
+#include <string>
+
+namespace {
+
+struct CountingResource : std::pmr::memory_resource {
+    int allocations = 0;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+constexpr std::string_view long_text = "a string too long for the small string buffer";
+
+std::pmr::string numbered_text(int i) {
+    std::pmr::string text{long_text, pipeline_allocator()};
+    text += std::to_string(i);
+    return text;
+}
+
+}
+
+TEST(MonadTests, NoMemoryResourceAttachedByDefault) {
+    EXPECT_EQ(std::pmr::get_default_resource(), pipeline_memory_resource());
+}
+
+TEST(MonadTests, MemoryResourceScopesNest) {
+    CountingResource outer;
+    CountingResource inner;
+    {
+        memory_resource_scope outer_scope{&outer};
+        EXPECT_EQ(&outer, pipeline_memory_resource());
+        {
+            memory_resource_scope inner_scope{&inner};
+            EXPECT_EQ(&inner, pipeline_memory_resource());
+        }
+        EXPECT_EQ(&outer, pipeline_memory_resource());
+    }
+    EXPECT_EQ(std::pmr::get_default_resource(), pipeline_memory_resource());
+}
+
+TEST(MonadTests, TransformAllocatesFromAttachedResource) {
+    CountingResource upstream;
+    std::pmr::monotonic_buffer_resource arena{&upstream};
+
+    auto result = resolve_with(&arena, std::make_optional<int>(5),
+        transform([](int i) { return numbered_text(i); }));
+
+    EXPECT_EQ(numbered_text(5), result.value());
+    EXPECT_EQ(&arena, result.value().get_allocator().resource());
+    EXPECT_EQ(1, upstream.allocations);
+}
+
+TEST(MonadTests, TransformMovesForeignResultIntoAttachedResource) {
+    std::pmr::monotonic_buffer_resource arena;
+
+    auto result = resolve_with(&arena, std::make_optional<int>(5),
+        transform([](int) { return std::pmr::string(long_text); }));
+
+    EXPECT_EQ(long_text, result.value());
+    EXPECT_EQ(&arena, result.value().get_allocator().resource());
+}
+
+TEST(MonadTests, ResultsKeepTheirResourceWithoutScope) {
+    std::pmr::monotonic_buffer_resource arena;
+
+    auto transformed = resolve(std::make_optional<int>(5),
+        transform([&arena](int) { return std::pmr::string(long_text, &arena); }));
+    auto recovered = resolve(std::optional<std::pmr::string>{},
+        or_else([&arena]() { return std::pmr::string(long_text, &arena); }));
+
+    EXPECT_EQ(long_text, transformed.value());
+    EXPECT_EQ(&arena, transformed.value().get_allocator().resource());
+    EXPECT_EQ(long_text, recovered.value());
+    EXPECT_EQ(&arena, recovered.value().get_allocator().resource());
+}
+
+TEST(MonadTests, OrElseAllocatesFromAttachedResource) {
+    std::pmr::monotonic_buffer_resource arena;
+
+    auto result = resolve_with(&arena, std::optional<std::pmr::string>{},
+        or_else([]() { return std::pmr::string(long_text, pipeline_allocator()); }));
+
+    EXPECT_EQ(long_text, result.value());
+    EXPECT_EQ(&arena, result.value().get_allocator().resource());
+}
+
+TEST(MonadTests, OrElseReturningOptionalAllocatesFromAttachedResource) {
+    std::pmr::monotonic_buffer_resource arena;
+
+    auto result = resolve_with(&arena, std::optional<std::pmr::string>{},
+        or_else([]() { return std::optional<std::pmr::string>{long_text}; }));
+
+    EXPECT_EQ(long_text, result.value());
+    EXPECT_EQ(&arena, result.value().get_allocator().resource());
+
+    auto empty = resolve_with(&arena, std::optional<std::pmr::string>{},
+        or_else([]() { return std::optional<std::pmr::string>{}; }));
+    EXPECT_FALSE(empty.has_value());
+}
+
+TEST(MonadTests, BatchOfResultsReleasedInOneGo) {
+    CountingResource upstream;
+    std::vector<std::optional<std::pmr::string>> results;
+    {
+        std::pmr::monotonic_buffer_resource arena{&upstream};
+        memory_resource_scope scope{&arena};
+
+        const std::vector<std::optional<int>> inputs{1, std::nullopt, 3};
+        resolve_all(inputs.begin(), inputs.end(), std::back_inserter(results),
+                    transform([](int i) { return numbered_text(i); }),
+                    or_else([]() { return std::pmr::string(long_text, pipeline_allocator()); }));
+
+        ASSERT_EQ(3u, results.size());
+        EXPECT_EQ(long_text, results[1].value());
+        for (const auto& result : results) {
+            EXPECT_EQ(&arena, result.value().get_allocator().resource());
+        }
+        EXPECT_LT(0, upstream.allocations);
+        results.clear();
+    }
+    EXPECT_EQ(std::pmr::get_default_resource(), pipeline_memory_resource());
+}
+
+TEST(MonadTests, NoCopyOnTransformWithAttachedResource) {
+    std::pmr::monotonic_buffer_resource arena;
+    TrackCopies::reset_counts();
+
+    auto result = resolve_with(&arena, std::make_optional<int>(1), transform([](int i) { return TrackCopies{i}; }));
+
+    EXPECT_EQ(1, result.value().value);
+    EXPECT_EQ(TrackCopies::copy_count, 0);
+    EXPECT_EQ(TrackCopies::move_count, 1);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <optional_column.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TempPath {
+    std::string path;
+
+    explicit TempPath(const char* name) : path{std::string{::testing::TempDir()} + name} {}
+
+    ~TempPath() {
+        std::remove(path.c_str());
+    }
+};
+
+}
+
+TEST(MonadTests, OptionalColumnRoundTripTest) {
+    TempPath file{"optional_column_round_trip.col"};
+    std::vector<std::optional<int>> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i % 3 == 0 ? std::nullopt : std::make_optional(i * 7));
+    }
+
+    {
+        optional_column_writer<int> writer{file.path.c_str(), values.size()};
+        std::copy(values.begin(), values.end(), writer.begin());
+    }
+
+    optional_column_view<int> view{file.path.c_str()};
+    ASSERT_EQ(values.size(), view.size());
+    EXPECT_EQ(values, std::vector<std::optional<int>>(view.begin(), view.end()));
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(view.values()) % optional_column_alignment);
+}
+
+TEST(MonadTests, OptionalColumnSetTest) {
+    TempPath file{"optional_column_set.col"};
+    {
+        optional_column_writer<double> writer{file.path.c_str(), 3};
+        writer.set(0, 1.5);
+        writer.set(2, std::make_optional(2.5));
+        writer.set(2, std::optional<double>{});
+        writer.set(1, std::make_optional(3.5));
+    }
+
+    optional_column_view<double> view{file.path.c_str()};
+    EXPECT_EQ(1.5, view[0].value());
+    EXPECT_EQ(3.5, view[1].value());
+    EXPECT_EQ(std::nullopt, view[2]);
+}
+
+TEST(MonadTests, OptionalColumnEmptyTest) {
+    TempPath file{"optional_column_empty.col"};
+    {
+        optional_column_writer<int> writer{file.path.c_str(), 0};
+    }
+
+    optional_column_view<int> view{file.path.c_str()};
+    EXPECT_EQ(0u, view.size());
+    EXPECT_TRUE(view.begin() == view.end());
+}
+
+TEST(MonadTests, OptionalColumnTypeMismatchTest) {
+    TempPath file{"optional_column_mismatch.col"};
+    {
+        optional_column_writer<int> writer{file.path.c_str(), 2};
+    }
+
+    EXPECT_THROW(optional_column_view<float>{file.path.c_str()}, std::runtime_error);
+    EXPECT_THROW(optional_column_view<unsigned>{file.path.c_str()}, std::runtime_error);
+    EXPECT_THROW(optional_column_view<long long>{file.path.c_str()}, std::runtime_error);
+}
+
+TEST(MonadTests, OptionalColumnNotAColumnTest) {
+    TempPath file{"optional_column_garbage.col"};
+    std::ofstream{file.path, std::ios::binary} << "definitely not a column, but long enough to have a header";
+
+    EXPECT_THROW(optional_column_view<int>{file.path.c_str()}, std::runtime_error);
+}
+
+TEST(MonadTests, OptionalColumnCorruptLengthTest) {
+    TempPath file{"optional_column_corrupt.col"};
+
+    for (std::uint64_t length : {std::uint64_t{1000}, ~std::uint64_t{0}, ~std::uint64_t{0} / sizeof(int) + 1}) {
+        const auto header = detail::make_column_header<int>(static_cast<std::size_t>(length));
+        std::string contents(128, '\0');
+        std::memcpy(contents.data(), &header, sizeof(header));
+        std::ofstream{file.path, std::ios::binary} << contents;
+
+        EXPECT_THROW(optional_column_view<int>{file.path.c_str()}, std::runtime_error);
+    }
+}
+
+TEST(MonadTests, OptionalColumnWriterRejectsHugeLengthTest) {
+    TempPath file{"optional_column_huge.col"};
+
+    for (std::size_t length : {~std::size_t{0}, ~std::size_t{0} - 62, ~std::size_t{0} / sizeof(int) + 1}) {
+        EXPECT_THROW((optional_column_writer<int>{file.path.c_str(), length}), std::length_error);
+    }
+}
+
+TEST(MonadTests, ResolveAllFromColumnToColumnTest) {
+    TempPath input{"optional_column_input.col"};
+    TempPath output{"optional_column_output.col"};
+
+    const std::vector<std::optional<int>> values{1, std::nullopt, -3, 4};
+    {
+        optional_column_writer<int> writer{input.path.c_str(), values.size()};
+        std::copy(values.begin(), values.end(), writer.begin());
+    }
+
+    {
+        optional_column_view<int> view{input.path.c_str()};
+        optional_column_writer<double> writer{output.path.c_str(), view.size()};
+        resolve_all(view.begin(), view.end(), writer.begin(),
+                    filter([](int x) { return x >= 0; }),
+                    transform([](int x) { return x / 2.0; }));
+    }
+
+    optional_column_view<double> view{output.path.c_str()};
+    EXPECT_EQ((std::vector<std::optional<double>>{0.5, std::nullopt, std::nullopt, 2.0}),
+              std::vector<std::optional<double>>(view.begin(), view.end()));
+}
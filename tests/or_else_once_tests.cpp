@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <or_else_once.hpp>
+#include "track_copies.hpp"
+
+#include <string>
+#include <thread>
+
+TEST(MonadTests, OrElseOnceComputesFallbackOnce) {
+    int calls = 0;
+    auto fallback = or_else_once([&calls]() { ++calls; return std::string{"default"}; });
+
+    std::optional<std::string> nothing;
+    EXPECT_EQ("default", resolve(nothing, fallback).value().get());
+    EXPECT_EQ("default", resolve(nothing, fallback).value().get());
+    EXPECT_EQ(1, calls);
+
+    const auto& first = resolve(nothing, fallback).value().get();
+    const auto& second = resolve(nothing, fallback).value().get();
+    EXPECT_EQ(&first, &second);
+}
+
+TEST(MonadTests, OrElseOnceSkipsFallbackOnValue) {
+    int calls = 0;
+    auto fallback = or_else_once([&calls]() { ++calls; return 25; });
+
+    auto five = std::make_optional<int>(5);
+    EXPECT_EQ(5, resolve(five, fallback).value().get());
+    EXPECT_EQ(&five.value(), &resolve(five, fallback).value().get());
+    EXPECT_EQ(0, calls);
+}
+
+TEST(MonadTests, OrElseOnceReturningOptional) {
+    int calls = 0;
+    auto fallback = or_else_once([&calls]() { ++calls; return std::optional<int>{}; });
+
+    std::optional<int> nothing;
+    EXPECT_EQ(std::nullopt, resolve(nothing, fallback));
+    EXPECT_EQ(std::nullopt, resolve(nothing, fallback));
+    EXPECT_EQ(1, calls);
+
+    auto table = or_else_once([]() { return std::make_optional<std::vector<int>>({1, 2, 3}); });
+    EXPECT_EQ(3u, resolve(std::optional<std::vector<int>>{}, table, transform([](const std::vector<int>& v) { return v.size(); })).value());
+}
+
+TEST(MonadTests, OrElseOnceInTheMiddleOfChain) {
+    int calls = 0;
+    auto fallback = or_else_once([&calls]() { ++calls; return std::string(32, 'd'); });
+    auto named = transform([](int x) { return x < 0 ? std::string(32, 'n') : std::string(32, 'p'); });
+    auto positive = filter([](const std::string& s) { return s[0] == 'p'; });
+
+    EXPECT_EQ(std::string(32, 'p'), resolve(std::make_optional(7), named, positive, fallback).value());
+    EXPECT_EQ(std::string(32, 'd'), resolve(std::make_optional(-7), named, positive, fallback).value());
+    EXPECT_EQ(std::string(32, 'd'), resolve(std::make_optional(-1), named, positive, fallback, transform([](std::string s) { return s; })).value());
+    EXPECT_EQ(1, calls);
+
+    auto maybe = or_else_once([]() { return std::make_optional(std::string(32, 'o')); });
+    EXPECT_EQ(std::string(32, 'o'), resolve(std::make_optional(-7), named, positive, maybe).value());
+    EXPECT_EQ(std::string(32, 'p'), resolve(std::make_optional(7), named, positive, maybe).value());
+}
+
+TEST(MonadTests, OrElseOnceSharedByCopies) {
+    int calls = 0;
+    auto fallback = or_else_once([&calls]() { ++calls; return 1; });
+    auto copy = fallback;
+
+    std::optional<int> nothing;
+    resolve(nothing, fallback);
+    resolve(nothing, copy);
+    EXPECT_EQ(1, calls);
+}
+
+TEST(MonadTests, OrElseOnceRetriesAfterException) {
+    int calls = 0;
+    auto fallback = or_else_once([&calls]() {
+        if (++calls == 1) {
+            throw std::runtime_error{"not yet"};
+        }
+        return 7;
+    });
+
+    std::optional<int> nothing;
+    EXPECT_THROW(resolve(nothing, fallback), std::runtime_error);
+    EXPECT_EQ(7, resolve(nothing, fallback).value().get());
+    EXPECT_EQ(2, calls);
+}
+
+TEST(MonadTests, OrElseOnceAcrossThreads) {
+    std::atomic<int> calls{0};
+    auto fallback = or_else_once([&calls]() {
+        ++calls;
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        return 42;
+    });
+
+    std::vector<std::thread> threads;
+    std::vector<const int*> results(8);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&fallback, &results, i]() {
+            std::optional<int> nothing;
+            results[i] = &resolve(nothing, fallback).value().get();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(1, calls.load());
+    for (auto result : results) {
+        EXPECT_EQ(results.front(), result);
+        EXPECT_EQ(42, *result);
+    }
+}
+
+TEST(MonadTests, NoCopyOnOrElseOnce) {
+    auto fallback = or_else_once([]() { return TrackCopies{3}; });
+    std::optional<TrackCopies> nothing;
+    resolve(nothing, fallback);
+
+    TrackCopies::reset_counts();
+    EXPECT_EQ(3, resolve(nothing, fallback).value().get().value);
+    EXPECT_EQ(TrackCopies::copy_count, 0);
+    EXPECT_EQ(TrackCopies::move_count, 0);
+}
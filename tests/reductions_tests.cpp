@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <reductions.hpp>
+
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+std::vector<std::optional<int>> make_inputs(int size) {
+    std::vector<std::optional<int>> inputs;
+    for (int i = 0; i < size; ++i) {
+        inputs.push_back(i % 3 == 0 ? std::nullopt : std::optional<int>{i % 101 - 50});
+    }
+    return inputs;
+}
+
+}
+
+TEST(MonadTests, ResolveReduceMatchesResolveThenAccumulateTest) {
+    const auto inputs = make_inputs(1000);
+    const auto square = transform([](int x) { return x * x; });
+    const auto odd = filter([](int x) { return x % 2 != 0; });
+
+    std::vector<int> resolved;
+    for (const auto& input : inputs) {
+        if (auto result = resolve(input, square, odd)) {
+            resolved.push_back(*result);
+        }
+    }
+
+    EXPECT_EQ(resolved.size(), resolve_reduce(inputs.begin(), inputs.end(), count_present(), square, odd));
+    EXPECT_EQ(std::accumulate(resolved.begin(), resolved.end(), 0), resolve_reduce(inputs.begin(), inputs.end(), sum_present(), square, odd));
+    EXPECT_EQ(*std::min_element(resolved.begin(), resolved.end()), resolve_reduce(inputs.begin(), inputs.end(), min_present(), square, odd));
+    EXPECT_EQ(*std::max_element(resolved.begin(), resolved.end()), resolve_reduce(inputs.begin(), inputs.end(), max_present(), square, odd));
+}
+
+TEST(MonadTests, ResolveReduceEmptyResultsTest) {
+    const std::vector<std::optional<double>> inputs{std::nullopt, 1.0, std::nullopt};
+    const auto none = filter([](double) { return false; });
+
+    EXPECT_EQ(0u, resolve_reduce(inputs.begin(), inputs.end(), count_present(), none));
+    EXPECT_EQ(0.0, resolve_reduce(inputs.begin(), inputs.end(), sum_present(), none));
+    EXPECT_EQ(std::nullopt, resolve_reduce(inputs.begin(), inputs.end(), min_present(), none));
+    EXPECT_EQ(std::nullopt, resolve_reduce(inputs.end(), inputs.end(), max_present()));
+
+    const std::vector<std::optional<int>> extremes{std::numeric_limits<int>::max(), std::numeric_limits<int>::lowest()};
+    EXPECT_EQ(std::numeric_limits<int>::max(), resolve_reduce(extremes.begin(), extremes.end(), max_present()));
+    EXPECT_EQ(std::numeric_limits<int>::lowest(), resolve_reduce(extremes.begin(), extremes.end(), min_present()));
+}
+
+TEST(MonadTests, ResolveReduceInfiniteExtremesTest) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    const std::vector<std::optional<double>> positive(20, infinity);
+    const std::vector<std::optional<double>> negative{-infinity, std::nullopt, 1.0};
+
+    EXPECT_EQ(infinity, resolve_reduce(positive.begin(), positive.end(), min_present()));
+    EXPECT_EQ(-infinity, resolve_reduce(positive.begin(), positive.end(), max_present(), transform([](double x) { return -x; })));
+    EXPECT_EQ(-infinity, resolve_reduce(negative.begin(), negative.end(), min_present()));
+
+    const std::vector<std::optional<unsigned>> small{0u, std::nullopt, 7u};
+    EXPECT_EQ(0u, resolve_reduce(small.begin(), small.end(), min_present()));
+    EXPECT_EQ(7u, resolve_reduce(small.begin(), small.end(), max_present()));
+}
+
+TEST(MonadTests, ResolveReduceFoldNonTrivialValuesTest) {
+    const std::vector<std::optional<std::string>> inputs{"a", std::nullopt, "b", "c"};
+    const auto concat = fold_present(std::string{}, [](std::string lhs, const std::string& rhs) { return lhs + rhs; });
+
+    EXPECT_EQ("abc", resolve_reduce(inputs.begin(), inputs.end(), concat));
+    EXPECT_EQ("ABC", resolve_reduce(inputs.begin(), inputs.end(), concat, transform([](std::string s) {
+        s[0] = static_cast<char>(s[0] - 'a' + 'A');
+        return s;
+    })));
+    EXPECT_EQ(std::string{"c"}, resolve_reduce(inputs.begin(), inputs.end(), max_present()));
+}
+
+TEST(MonadTests, ResolveReduceReferenceResultsTest) {
+    const std::vector<std::pair<int, int>> pairs{{1, 10}, {2, 20}, {3, 30}};
+    std::vector<std::optional<std::pair<int, int>>> inputs{pairs[0], std::nullopt, pairs[1], pairs[2]};
+    const auto second = transform([](const std::pair<int, int>& p) -> const int& { return p.second; });
+
+    EXPECT_EQ(60, resolve_reduce(inputs.begin(), inputs.end(), sum_present(), second));
+    EXPECT_EQ(10, resolve_reduce(inputs.begin(), inputs.end(), min_present(), second));
+}
+
+TEST(MonadTests, ResolveReduceParallelMatchesSequentialTest) {
+    const auto inputs = make_inputs(10000);
+    const auto twice = transform([](int x) { return static_cast<long long>(x) * 2; });
+
+    for (std::size_t threads : {std::size_t{0}, std::size_t{1}, std::size_t{3}, std::size_t{8}}) {
+        EXPECT_EQ(resolve_reduce(inputs.begin(), inputs.end(), count_present(), twice),
+                  resolve_reduce_parallel(inputs.begin(), inputs.end(), threads, count_present(), twice));
+        EXPECT_EQ(resolve_reduce(inputs.begin(), inputs.end(), sum_present(), twice),
+                  resolve_reduce_parallel(inputs.begin(), inputs.end(), threads, sum_present(), twice));
+        EXPECT_EQ(resolve_reduce(inputs.begin(), inputs.end(), min_present(), twice),
+                  resolve_reduce_parallel(inputs.begin(), inputs.end(), threads, min_present(), twice));
+        EXPECT_EQ(resolve_reduce(inputs.begin(), inputs.end(), max_present(), twice),
+                  resolve_reduce_parallel(inputs.begin(), inputs.end(), threads, max_present(), twice));
+    }
+}
+
+TEST(MonadTests, ResolveReduceParallelKeepsFoldOrderTest) {
+    std::vector<std::optional<std::string>> inputs;
+    std::string expected;
+    for (int i = 0; i < 3000; ++i) {
+        const auto letter = std::string(1, static_cast<char>('a' + i % 26));
+        inputs.push_back(i % 5 == 0 ? std::nullopt : std::optional<std::string>{letter});
+        if (i % 5 != 0) {
+            expected += letter;
+        }
+    }
+    const auto concat = fold_present(std::string{}, [](std::string lhs, const std::string& rhs) { return lhs + rhs; });
+
+    EXPECT_EQ(expected, resolve_reduce_parallel(inputs.begin(), inputs.end(), 4, concat));
+}
+
+TEST(MonadTests, ResolveReduceParallelPropagatesExceptionsTest) {
+    const auto inputs = make_inputs(4000);
+    const auto throwing = transform([](int x) {
+        if (x == 42) {
+            throw std::runtime_error("bad value");
+        }
+        return x;
+    });
+
+    EXPECT_THROW(resolve_reduce_parallel(inputs.begin(), inputs.end(), 4, sum_present(), throwing), std::runtime_error);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <staged_pipeline.hpp>
+
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+TEST(MonadTests, SpscRingBatchedHandOffTest) {
+    spsc_ring<int> ring{5};
+    EXPECT_EQ(8u, ring.capacity());
+
+    const std::vector<int> values{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    EXPECT_EQ(8u, ring.try_push(values.begin(), values.size()));
+    EXPECT_EQ(0u, ring.try_push(values.begin() + 8, 2));
+    EXPECT_EQ(8u, ring.size());
+
+    std::vector<int> popped;
+    EXPECT_EQ(3u, ring.try_pop(std::back_inserter(popped), 3));
+    EXPECT_EQ(2u, ring.try_push(values.begin() + 8, 2));
+    EXPECT_EQ(7u, ring.try_pop(std::back_inserter(popped), 10));
+    EXPECT_EQ(0u, ring.try_pop(std::back_inserter(popped), 10));
+    EXPECT_EQ(values, popped);
+
+    EXPECT_FALSE(ring.closed());
+    ring.close();
+    EXPECT_TRUE(ring.closed());
+}
+
+TEST(MonadTests, SpscRingAcrossThreadsTest) {
+    spsc_ring<int> ring{16};
+    std::vector<int> expected(100000);
+    std::iota(expected.begin(), expected.end(), 0);
+
+    std::thread producer([&ring, &expected]() {
+        for (auto next = expected.begin(); next != expected.end();) {
+            const auto pushed = ring.try_push(next, std::min<std::size_t>(5, static_cast<std::size_t>(expected.end() - next)));
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+            next += static_cast<std::ptrdiff_t>(pushed);
+        }
+        ring.close();
+    });
+
+    std::vector<int> popped;
+    while (true) {
+        const bool closed = ring.closed();
+        if (ring.try_pop(std::back_inserter(popped), 7) == 0) {
+            if (closed) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(expected, popped);
+}
+
+TEST(MonadTests, ResolveStagedMatchesResolveTest) {
+    std::vector<std::optional<int>> inputs;
+    for (int i = 0; i < 10000; ++i) {
+        inputs.push_back(i % 13 == 0 ? std::nullopt : std::make_optional(i));
+    }
+
+    auto parse = transform([](int x) { return std::to_string(x); });
+    auto odd = filter([](const std::string& s) { return (s.back() - '0') % 2 == 1; });
+    auto size = transform([](const std::string& s) { return s.size(); });
+
+    std::vector<std::size_t> results;
+    auto staged = resolve_staged(inputs.begin(), inputs.end(), std::back_inserter(results), staged_options{8, 16}, parse, odd, size);
+
+    std::vector<std::size_t> expected;
+    for (auto& input : inputs) {
+        resolve_into(std::back_inserter(expected), input, parse, odd, size);
+    }
+    EXPECT_EQ(expected, results);
+
+    EXPECT_EQ(inputs.size(), staged.stages[0].processed);
+    EXPECT_EQ(staged.stages[0].emitted, staged.stages[1].processed);
+    EXPECT_EQ(staged.stages[1].emitted, staged.stages[2].processed);
+    EXPECT_EQ(expected.size(), staged.stages[2].emitted);
+    for (const auto& stage : staged.stages) {
+        EXPECT_LE(stage.max_queue_occupancy, 8u);
+        EXPECT_LE(stage.mean_queue_occupancy, 8.0);
+    }
+}
+
+TEST(MonadTests, ResolveStagedDropsEmptyElementsEarlyTest) {
+    const std::vector<std::optional<int>> inputs{1, 2, std::nullopt, 4, 5, 6};
+    int last_stage_calls = 0;
+
+    std::vector<int> results;
+    auto staged = resolve_staged(inputs.begin(), inputs.end(), std::back_inserter(results),
+                                 or_else([]() { return 3; }),
+                                 filter([](int x) { return x % 2 == 0; }),
+                                 transform([&last_stage_calls](int x) { ++last_stage_calls; return x * 10; }));
+
+    EXPECT_EQ((std::vector<int>{20, 40, 60}), results);
+    EXPECT_EQ(3, last_stage_calls);
+    EXPECT_EQ(3u, staged.stages[2].processed);
+}
+
+TEST(MonadTests, ResolveStagedPassesEmptyElementsToRecoveringStageTest) {
+    const std::vector<std::optional<int>> inputs{1, 2, std::nullopt, 4, 5};
+    auto even = filter([](int x) { return x % 2 == 0; });
+    auto zero = or_else([]() { return 0; });
+    auto doubled = transform([](int x) { return x * 2; });
+
+    std::vector<int> results;
+    auto staged = resolve_staged(inputs.begin(), inputs.end(), std::back_inserter(results), even, zero, doubled);
+
+    std::vector<std::optional<int>> expected;
+    resolve_all(inputs.begin(), inputs.end(), std::back_inserter(expected), even, zero, doubled);
+    EXPECT_EQ((std::vector<std::optional<int>>{0, 4, 0, 8, 0}), expected);
+    EXPECT_EQ((std::vector<int>{0, 4, 0, 8, 0}), results);
+    EXPECT_EQ(5u, staged.stages[1].processed);
+}
+
+TEST(MonadTests, ResolveStagedUsesCallersMemoryResourceTest) {
+    const std::vector<std::optional<int>> inputs{1, std::nullopt, 3};
+    std::pmr::synchronized_pool_resource arena;
+    memory_resource_scope scope{&arena};
+
+    std::vector<std::pmr::string> results;
+    resolve_staged(inputs.begin(), inputs.end(), std::back_inserter(results),
+                   transform([](int x) { return std::pmr::string(64, static_cast<char>('0' + x)); }),
+                   or_else([]() { return std::pmr::string(64, '-'); }));
+
+    ASSERT_EQ(3u, results.size());
+    EXPECT_EQ(std::pmr::string(64, '-'), results[1]);
+    for (const auto& result : results) {
+        EXPECT_EQ(&arena, result.get_allocator().resource());
+    }
+}
+
+TEST(MonadTests, ResolveStagedSingleStageTest) {
+    const std::vector<std::optional<int>> inputs{1, std::nullopt, 3};
+    std::vector<int> results;
+
+    resolve_staged(inputs.begin(), inputs.end(), std::back_inserter(results), transform([](int x) { return -x; }));
+    EXPECT_EQ((std::vector<int>{-1, -3}), results);
+}
+
+TEST(MonadTests, ResolveStagedPropagatesExceptionsTest) {
+    std::vector<std::optional<int>> inputs(10000, 1);
+    std::vector<int> results;
+    int calls = 0;
+
+    EXPECT_THROW(resolve_staged(inputs.begin(), inputs.end(), std::back_inserter(results),
+                                transform([](int x) { return x; }),
+                                transform([&calls](int x) -> int {
+                                    if (++calls == 500) {
+                                        throw std::runtime_error{"stage failed"};
+                                    }
+                                    return x;
+                                })),
+                 std::runtime_error);
+}
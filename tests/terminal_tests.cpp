@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <monadic_operations.hpp>
+#include "track_copies.hpp"
+
+#include <array>
+#include <string>
+
+TEST(MonadTests, ValueOrElseTest) {
+    int fallback_calls = 0;
+    auto fallback = [&fallback_calls]() { ++fallback_calls; return 25; };
+
+    EXPECT_EQ(5, resolve(std::make_optional<int>(5), value_or_else(fallback)));
+    EXPECT_EQ(0, fallback_calls);
+
+    EXPECT_EQ(25, resolve(std::optional<int>{}, value_or_else(fallback)));
+    EXPECT_EQ(1, fallback_calls);
+
+    EXPECT_EQ(std::string{"fallback"}, resolve(std::make_optional<int>(3),
+                                              filter([](int x) { return x > 5; }),
+                                              transform([](int x) { return std::to_string(x); }),
+                                              value_or_else([]() { return "fallback"; })));
+}
+
+TEST(MonadTests, ValueOrElseOnReferenceTest) {
+    int five = 5;
+    int fallback = 25;
+
+    auto value = resolve(std::optional<std::reference_wrapper<int>>{five}, value_or_else([&fallback]() -> int& { return fallback; }));
+    value.get() = 6;
+    EXPECT_EQ(6, five);
+
+    auto value_from_else = resolve(std::optional<std::reference_wrapper<int>>{}, value_or_else([&fallback]() -> int& { return fallback; }));
+    value_from_else.get() = 26;
+    EXPECT_EQ(26, fallback);
+}
+
+TEST(MonadTests, NoCopyOnValueOrElseTest) {
+    TrackCopies::reset_counts();
+
+    auto value = resolve(std::make_optional<TrackCopies>(3), value_or_else([]() { return TrackCopies{}; }));
+    EXPECT_EQ(3, value.value);
+    EXPECT_EQ(TrackCopies::copy_count, 0);
+    EXPECT_EQ(TrackCopies::move_count, 1);
+
+    TrackCopies::reset_counts();
+
+    auto fallback = resolve(std::optional<TrackCopies>{}, value_or_else([]() { return TrackCopies{4}; }));
+    EXPECT_EQ(4, fallback.value);
+    EXPECT_EQ(TrackCopies::copy_count, 0);
+    EXPECT_EQ(TrackCopies::move_count, 0);
+}
+
+TEST(MonadTests, ResolveIntoSlotTest) {
+    int slot = -1;
+
+    EXPECT_TRUE(resolve_into(slot, std::make_optional<int>(5), transform([](int x) { return x * 2; })));
+    EXPECT_EQ(10, slot);
+
+    EXPECT_FALSE(resolve_into(slot, std::make_optional<int>(5), filter([](int x) { return x > 5; })));
+    EXPECT_EQ(10, slot);
+}
+
+TEST(MonadTests, ResolveIntoOptionalSlotTest) {
+    std::optional<int> slot;
+
+    EXPECT_TRUE(resolve_into(slot, std::make_optional<int>(5), transform([](int x) { return x * 2; })));
+    EXPECT_EQ(10, slot.value());
+
+    EXPECT_FALSE(resolve_into(slot, std::make_optional<int>(5), filter([](int x) { return x > 5; })));
+    EXPECT_EQ(std::nullopt, slot);
+}
+
+TEST(MonadTests, ResolveIntoOutputIteratorTest) {
+    std::array<int, 3> values{};
+    auto out = values.begin();
+
+    const std::array<std::optional<int>, 4> inputs{1, std::nullopt, 3, 4};
+    for (const auto& input : inputs) {
+        resolve_into(out, input, transform([](int x) { return x * x; }));
+    }
+
+    EXPECT_EQ((std::array<int, 3>{1, 9, 16}), values);
+    EXPECT_EQ(values.end(), out);
+
+    std::vector<std::string> strings;
+    resolve_into(std::back_inserter(strings), std::make_optional<int>(7), transform([](int x) { return std::to_string(x); }));
+    EXPECT_EQ((std::vector<std::string>{"7"}), strings);
+}
+
+TEST(MonadTests, NoCopyOnResolveIntoTest) {
+    TrackCopies slot;
+    TrackCopies::reset_counts();
+
+    EXPECT_TRUE(resolve_into(slot, std::make_optional<int>(2), transform([](int x) { return TrackCopies{x}; })));
+    EXPECT_EQ(2, slot.value);
+    EXPECT_EQ(TrackCopies::copy_count, 0);
+    EXPECT_EQ(TrackCopies::move_count, 2);
+}
+
+TEST(MonadTests, NoMoveOfFinalOptionalOnResolveIntoTest) {
+    TrackCopies slot;
+    auto not_empty = std::make_optional<TrackCopies>(15);
+    auto fallback = std::make_optional<TrackCopies>(12);
+    TrackCopies::reset_counts();
+
+    EXPECT_TRUE(resolve_into(slot, std::move(not_empty), or_else([&fallback]() -> decltype(auto) { return std::move(fallback); })));
+    EXPECT_EQ(15, slot.value);
+    EXPECT_EQ(TrackCopies::copy_count, 0);
+    EXPECT_EQ(TrackCopies::move_count, 1);
+}